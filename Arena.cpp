@@ -0,0 +1,182 @@
+// Arena.cpp — Cài đặt chế độ đấu trường nhiều rắn
+
+#include "Arena.h"
+#include <algorithm>
+
+using namespace std;
+
+static const int STEP_X[4] = { -1, 1, 0, 0 };  // Theo thứ tự DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN
+static const int STEP_Y[4] = { 0, 0, -1, 1 };
+
+static Point Move(const Point& p, int dir) {
+    return { p.x + STEP_X[dir], p.y + STEP_Y[dir] };
+}
+
+bool Arena::Reset(const MapData& m, int snakeCount, uint64_t seed, int target, int length) {
+    if ((size_t)m.width * m.height > (size_t)DENSE_BOARD_CELLS) return false;
+    map = &m;
+    size_t cells = (size_t)m.Stride() * (m.height + 1);
+    owner.assign(cells, -1);
+    food.assign(cells, 0);
+    claimTick.assign(cells, 0);
+    claimBy.assign(cells, -1);
+    claimStamp = 0;
+    freeCells.Reset((int)cells);
+    for (int y = 1; y < m.height; y++)
+        for (int x = 1; x < m.width; x++)
+            if (!IsBlocked(m, { x, y })) freeCells.Insert(m.Index(x, y));
+
+    rng.Seed(seed);
+    ticks = 0;
+    foodCount = 0;
+    foodTarget = target;
+    startLength = max(1, length);
+    aliveCount = 0;
+    snakes.assign(snakeCount, ArenaSnake());
+    next.resize(snakeCount);
+    dying.assign(snakeCount, 0);
+    for (int i = 0; i < snakeCount; i++) {
+        snakes[i].body.reserve(startLength * 2);
+        Respawn(i);
+    }
+    while (foodCount < foodTarget && !freeCells.Empty()) SpawnFood();
+    return true;
+}
+
+bool Arena::Respawn(int i) {
+    ArenaSnake& s = snakes[i];
+    if (s.alive || freeCells.Empty()) return false;
+    int cell = freeCells.At((int)rng.Below((uint32_t)freeCells.Size()));
+    freeCells.Erase(cell);
+    owner[cell] = i;
+    s.body.clear();
+    s.body.push_back({ cell % map->Stride(), cell / map->Stride() });
+    s.moving = (int)rng.Below(4);
+    s.grow = startLength - 1;
+    s.alive = true;
+    aliveCount++;
+    return true;
+}
+
+void Arena::SpawnFood() {
+    int cell = freeCells.At((int)rng.Below((uint32_t)freeCells.Size()));
+    freeCells.Erase(cell);
+    food[cell] = 1;
+    foodCount++;
+}
+
+// Trả các ô thân về bàn chơi; một phần thành mồi để các con khác tranh
+void Arena::Kill(int i) {
+    ArenaSnake& s = snakes[i];
+    for (size_t k = 0; k < s.body.size(); k++) {
+        int cell = map->Index(s.body[k].x, s.body[k].y);
+        owner[cell] = -1;
+        if (deathFoodStride > 0 && k % deathFoodStride == 0) {
+            food[cell] = 1;
+            foodCount++;
+        }
+        else freeCells.Insert(cell);
+    }
+    s.body.clear();
+    s.alive = false;
+    s.deaths++;
+    aliveCount--;
+}
+
+int Arena::Step(const int* dirs) {
+    int n = (int)snakes.size();
+    if (++claimStamp == 0) {
+        fill(claimTick.begin(), claimTick.end(), 0);
+        claimStamp = 1;
+    }
+
+    // 1. Mỗi đầu giành ô kế tiếp; ô đã có đầu khác giành là va chạm đầu-đầu (kể cả tranh cùng một mồi)
+    for (int i = 0; i < n; i++) {
+        ArenaSnake& s = snakes[i];
+        if (!s.alive) continue;
+        if (CanChangeDirection(dirs[i], s.moving, s.body.size())) s.moving = dirs[i];
+        next[i] = Move(s.body.back(), s.moving);
+        int cell = map->Index(next[i].x, next[i].y);
+        dying[i] = 0;
+        if (claimTick[cell] == claimStamp) {
+            dying[i] = 1;
+            dying[claimBy[cell]] = 1;
+        }
+        else {
+            claimTick[cell] = claimStamp;
+            claimBy[cell] = i;
+        }
+    }
+
+    // 2. Đầu-thân và tường, theo trạng thái trước khi con nào di chuyển: ô đuôi vẫn chặn như SnakeSim,
+    // nên kết quả không phụ thuộc thứ tự xử lý các con rắn
+    for (int i = 0; i < n; i++) {
+        if (!snakes[i].alive || dying[i]) continue;
+        const Point& p = next[i];
+        int hit = owner[map->Index(p.x, p.y)];
+        if (IsBlocked(*map, p) || hit >= 0) {
+            dying[i] = 1;
+            if (hit >= 0 && hit != i) snakes[hit].kills++;
+        }
+    }
+
+    // 3. Xóa con chết trước: không đầu nào còn sống nhắm vào ô thân của chúng (các ô đó đã chặn ở bước 2)
+    int deaths = 0;
+    for (int i = 0; i < n; i++) {
+        if (snakes[i].alive && dying[i]) {
+            Kill(i);
+            deaths++;
+        }
+    }
+
+    // 4. Con sống đi một ô: thêm đầu, ăn mồi hoặc bỏ đuôi
+    for (int i = 0; i < n; i++) {
+        ArenaSnake& s = snakes[i];
+        if (!s.alive) continue;
+        int cell = map->Index(next[i].x, next[i].y);
+        if (food[cell]) {
+            food[cell] = 0;
+            foodCount--;
+            s.score++;
+            s.grow++;
+        }
+        else freeCells.Erase(cell);
+        owner[cell] = i;
+        s.body.push_back(next[i]);
+
+        if (s.grow > 0) s.grow--;
+        else {
+            const Point& tail = s.body.front();
+            int tailCell = map->Index(tail.x, tail.y);
+            owner[tailCell] = -1;
+            freeCells.Insert(tailCell);
+            s.body.pop_front();
+        }
+    }
+
+    // 5. Bù mồi đã ăn (chỉ tốn theo số mồi bị ăn trong tick)
+    while (foodCount < foodTarget && !freeCells.Empty()) SpawnFood();
+    ticks++;
+    return deaths;
+}
+
+int Arena::WanderDirection(int i) {
+    const ArenaSnake& s = snakes[i];
+    if (!s.alive) return s.moving;
+    const Point& head = s.body.back();
+
+    int safe[4], safeCount = 0;
+    for (int dir = 0; dir < 4; dir++) {
+        if (!CanChangeDirection(dir, s.moving, s.body.size())) continue;
+        Point p = Move(head, dir);
+        if (IsBlocked(*map, p) || owner[map->Index(p.x, p.y)] >= 0) continue;
+        if (food[map->Index(p.x, p.y)]) return dir;
+        safe[safeCount++] = dir;
+    }
+    if (safeCount == 0) return s.moving;
+
+    // Đi thẳng nếu được, mỗi ô có 1/8 cơ hội rẽ để bot không chỉ chạy dọc tường
+    bool straight = find(safe, safe + safeCount, s.moving) != safe + safeCount;
+    if (straight && (rng.Next() & 7) != 0) return s.moving;
+    return safe[rng.Below((uint32_t)safeCount)];
+}
@@ -0,0 +1,74 @@
+// Arena.h — Chế độ đấu trường: hàng trăm con rắn (người chơi và bot) trên cùng một bản đồ lớn
+//
+// Mỗi ô giữ chỉ số con rắn đang nằm trên nó (lưới chủ sở hữu), nên va chạm đầu-thân chỉ là một lần
+// đọc mảng, không quét thân rắn nào. Va chạm đầu-đầu và tranh mồi dùng lưới "giành ô" đánh dấu theo
+// số tick: hai đầu giành cùng một ô thì cả hai chết. Một tick chỉ chạm tới ô đầu mới và ô đuôi cũ của
+// từng con đang đi, cộng thân của con vừa chết, nên chi phí tỉ lệ với số đầu rắn chứ không với tổng
+// độ dài các thân.
+//
+// Luật giống SnakeSim: ô đuôi hiện tại vẫn chặn (kiểm tra va chạm trước khi bỏ đuôi), không quay đầu,
+// ăn mồi thì dài thêm một ô.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "SnakeSim.h"
+#include "RingBuffer.h"
+#include "CellSet.h"
+#include "Random.h"
+
+struct ArenaSnake {
+    RingBuffer<Point> body;   // front() = đuôi, back() = đầu
+    int moving = DIR_RIGHT;
+    bool alive = false;
+    int grow = 0;             // Số tick còn giữ đuôi (vừa ăn, vừa sinh ra còn ngắn)
+    int score = 0;            // Số mồi đã ăn
+    int kills = 0;            // Số con đâm vào thân con này
+    int deaths = 0;
+};
+
+class Arena {
+public:
+    // Dùng map (người gọi giữ map sống lâu hơn Arena) cho snakeCount con rắn, tất cả sinh ngẫu nhiên.
+    // Trên bàn luôn có tối đa foodTarget mồi; con mới sinh dài dần tới startLength ô.
+    // Các lưới theo ô là mảng dày: false (không đổi gì) nếu map quá DENSE_BOARD_CELLS ô
+    bool Reset(const MapData& map, int snakeCount, uint64_t seed, int foodTarget, int startLength = 4);
+
+    // Sinh lại con rắn i (đã chết) ở một ô trống ngẫu nhiên; false nếu còn sống hoặc bàn đầy
+    bool Respawn(int i);
+
+    // Một tick cho mọi con đang sống, dirs[i] là hướng của con i (quay đầu thì giữ hướng cũ).
+    // Trả về số con chết trong tick
+    int Step(const int* dirs);
+
+    // Hướng cho bot đơn giản: không đi vào tường hay thân rắn, có mồi kề bên thì ăn, thỉnh thoảng rẽ
+    int WanderDirection(int i);
+
+    // -1 nếu ô trống hoặc là tường
+    int Owner(const Point& p) const { return owner[map->Index(p.x, p.y)]; }
+    bool HasFood(const Point& p) const { return food[map->Index(p.x, p.y)] != 0; }
+
+    const MapData* map = nullptr;
+    std::vector<ArenaSnake> snakes;
+    int aliveCount = 0;
+    int foodCount = 0;
+    int foodTarget = 0;
+    int startLength = 4;
+    int deathFoodStride = 2;  // Thân con vừa chết thành mồi, cứ mỗi deathFoodStride ô một mồi (0 = không)
+    uint64_t ticks = 0;
+    Pcg32 rng;
+
+private:
+    std::vector<int> owner;           // Theo map.Index (gồm viền), -1 = không có thân rắn
+    std::vector<uint8_t> food;
+    std::vector<uint32_t> claimTick;  // claimTick[ô] == claimStamp: đã có đầu giành ô này trong tick
+    std::vector<int> claimBy;         // Con rắn giành ô đầu tiên
+    uint32_t claimStamp = 0;
+    CellSet freeCells;                // Ô không tường, không thân, không mồi: đặt mồi và sinh rắn O(1)
+    std::vector<Point> next;          // Ô đầu mới của từng con trong tick đang xử lý
+    std::vector<uint8_t> dying;
+
+    void Kill(int i);
+    void SpawnFood();
+};
@@ -0,0 +1,216 @@
+// Autopilot.cpp — Cài đặt bot tự lái
+
+#include "Autopilot.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+static const int STEP_X[4] = { -1, 1, 0, 0 };  // Theo thứ tự DIR_LEFT, DIR_RIGHT, DIR_UP, DIR_DOWN
+static const int STEP_Y[4] = { 0, 0, -1, 1 };
+
+// Mục tiêu hiện tại: mồi đang hiện, nếu không thì cổng qua màn
+static bool FindTarget(const SnakeSim& sim, Point& target) {
+    if (sim.foodVisible && sim.foodIndex >= 0 && sim.foodIndex < (int)sim.foods.size()) {
+        target = sim.foods[sim.foodIndex];
+        return true;
+    }
+    if (sim.gateActive) {
+        target = sim.gatePos;
+        return true;
+    }
+    return false;
+}
+
+static int DirectionTo(const Point& from, const Point& to) {
+    if (to.x < from.x) return DIR_LEFT;
+    if (to.x > from.x) return DIR_RIGHT;
+    if (to.y < from.y) return DIR_UP;
+    return DIR_DOWN;
+}
+
+// Bàn lớn hơn DENSE_BOARD_CELLS ô: không cấp phát mảng tìm kiếm theo ô, chỉ đi tham về mục tiêu
+// trong các hướng không chết ngay (hòa thì giữ hướng đang đi)
+static int LocalDirection(const SnakeSim& sim, const Point* target) {
+    int best = sim.moving;
+    long long bestDist = -1;
+    for (int i = 0; i < 4; i++) {
+        int dir = (sim.moving + i) % 4;
+        if (!CanChangeDirection(dir, sim.moving, sim.snake.size())) continue;
+        Point nh = sim.NextHead(dir);
+        if (sim.HitWall(nh) || sim.HitSelf(nh)) continue;
+        long long dist = target ? llabs((long long)nh.x - target->x) + llabs((long long)nh.y - target->y) : 0;
+        if (bestDist < 0 || dist < bestDist) {
+            best = dir;
+            bestDist = dist;
+        }
+    }
+    return best;
+}
+
+// Cấp phát theo kích thước map (chỉ khi gặp map lớn hơn) và đánh dấu thân rắn cho lần tìm này
+void Autopilot::Prepare(const SnakeSim& sim) {
+    width = sim.gridWidth;
+    height = sim.gridHeight;
+    size_t cells = (size_t)width * height;
+    if (seen.size() < cells) {
+        seen.assign(cells, 0);
+        parent.resize(cells);
+        depth.resize(cells);
+        bodyStamp.assign(cells, 0);
+        bodyIndex.resize(cells);
+        queue.resize(cells);
+        path.reserve(cells);
+        stamp = bodyGen = 0;
+    }
+
+    if (++bodyGen == 0) {
+        // Hết số thế hệ: xóa dấu cũ một lần
+        fill(bodyStamp.begin(), bodyStamp.end(), 0);
+        bodyGen = 1;
+    }
+    for (size_t i = 0; i < sim.snake.size(); i++) {
+        const Point& p = sim.snake[i];
+        if (p.x <= 0 || p.x >= width || p.y <= 0 || p.y >= height) continue;
+        int cell = p.y * width + p.x;
+        bodyStamp[cell] = bodyGen;
+        bodyIndex[cell] = (int)i;
+    }
+}
+
+void Autopilot::NewSearch() {
+    if (++stamp == 0) {
+        fill(seen.begin(), seen.end(), 0);
+        stamp = 1;
+    }
+}
+
+// Thân rắn có còn ở cell khi đầu tới đó ở bước thứ arrive (1 = bước kế tiếp) không (tường kiểm tra riêng):
+// đoạn thân i rời ô sau bước i + 1 (Step kiểm tra va chạm trước khi bỏ đuôi nên không vào được ô đuôi hiện tại)
+bool Autopilot::Passable(int cell, int arrive) const {
+    return bodyStamp[cell] != bodyGen || bodyIndex[cell] + 2 <= arrive;
+}
+
+bool Autopilot::FindPath(const SnakeSim& sim, const Point& target) {
+    const Point& head = sim.snake.back();
+    int start = head.y * width + head.x;
+    int goal = target.y * width + target.x;
+
+    NewSearch();
+    int qHead = 0, qTail = 0;
+    queue[qTail++] = start;
+    seen[start] = stamp;
+    depth[start] = 0;
+    while (qHead < qTail) {
+        int cell = queue[qHead++];
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 4; d++) {
+            Point n{ x + STEP_X[d], y + STEP_Y[d] };
+            // Ô trên viền: kiểm tra tường trước khi đổi sang chỉ số (x = width sẽ trùng ô đầu hàng sau)
+            if (IsBlocked(*sim.activeMap, n)) continue;
+            int next = n.y * width + n.x;
+            if (seen[next] == stamp || !Passable(next, depth[cell] + 1)) continue;
+            seen[next] = stamp;
+            parent[next] = cell;
+            depth[next] = depth[cell] + 1;
+            if (next == goal) {
+                // Dừng sớm: BFS gặp mục tiêu lần đầu là đường ngắn nhất
+                path.clear();
+                for (int c = goal; c != start; c = parent[c]) path.push_back(c);
+                reverse(path.begin(), path.end());
+                return true;
+            }
+            queue[qTail++] = next;
+        }
+    }
+    return false;
+}
+
+// Số ô đi tới được từ start (tới tối đa limit ô), để chọn hướng ít bị kẹt nhất khi không có đường
+int Autopilot::CountReachable(const SnakeSim& sim, int start, int limit) {
+    NewSearch();
+    int qHead = 0, qTail = 0, count = 0;
+    queue[qTail++] = start;
+    seen[start] = stamp;
+    depth[start] = 1;
+    while (qHead < qTail && count < limit) {
+        int cell = queue[qHead++];
+        count++;
+        int x = cell % width, y = cell / width;
+        for (int d = 0; d < 4; d++) {
+            Point n{ x + STEP_X[d], y + STEP_Y[d] };
+            if (IsBlocked(*sim.activeMap, n)) continue;
+            int next = n.y * width + n.x;
+            if (seen[next] == stamp || !Passable(next, depth[cell] + 1)) continue;
+            seen[next] = stamp;
+            depth[next] = depth[cell] + 1;
+            queue[qTail++] = next;
+        }
+    }
+    return count;
+}
+
+int Autopilot::SafestDirection(const SnakeSim& sim) {
+    int best = sim.moving, bestCount = -1;
+    int limit = (int)sim.snake.size() * 2 + 16; // Đủ chỗ cho cả thân rắn là an toàn, không cần đếm hết
+    for (int i = 0; i < 4; i++) {
+        int dir = (sim.moving + i) % 4; // Hòa thì giữ hướng đang đi
+        if (!CanChangeDirection(dir, sim.moving, sim.snake.size())) continue;
+        Point nh = sim.NextHead(dir);
+        if (sim.HitWall(nh) || sim.HitSelf(nh)) continue;
+        int count = CountReachable(sim, nh.y * width + nh.x, limit);
+        if (count > bestCount) {
+            best = dir;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+int Autopilot::NextDirection(const SnakeSim& sim) {
+    if (!sim.alive || sim.snake.empty() || sim.headOffBoard) return sim.moving;
+    const Point& head = sim.snake.back();
+
+    Point target;
+    bool hasTarget = FindTarget(sim, target);
+    if ((uint64_t)sim.gridWidth * sim.gridHeight > (uint64_t)DENSE_BOARD_CELLS)
+        return LocalDirection(sim, hasTarget ? &target : nullptr);
+
+    // Dùng lại đường cũ: cùng map, cùng mục tiêu, rắn vừa đi đúng một bước theo đường.
+    // Thân rắn chỉ đi theo đường đã tính nên không ô nào trên phần đường còn lại bị chặn thêm
+    if (hasTarget && pathMap == sim.activeMap && pathTarget == target && sim.ticks == pathTick + 1 &&
+        pathPos < path.size() && head.y * width + head.x == path[pathPos]) {
+        pathPos++;
+        if (pathPos < path.size()) {
+            Point next{ path[pathPos] % width, path[pathPos] / width };
+            if (!sim.HitWall(next) && !sim.HitSelf(next)) {
+                reuses++;
+                pathTick = sim.ticks;
+                return DirectionTo(head, next);
+            }
+        }
+    }
+
+    Prepare(sim);
+    path.clear();
+    pathMap = nullptr;
+
+    // Mục tiêu vừa tìm không thấy đường (mồi trong ô bị tường vây, thân rắn chắn lối): chỉ tìm lại
+    // sau khi thân rắn đã đi hết một lượt, không duyệt cả bàn chơi ở mỗi tick
+    bool retry = !(failMap == sim.activeMap && failTarget == target && sim.ticks < retryTick);
+    if (hasTarget && retry) {
+        searches++;
+        if (FindPath(sim, target)) {
+            pathPos = 0;
+            pathMap = sim.activeMap;
+            pathTarget = target;
+            pathTick = sim.ticks;
+            failMap = nullptr;
+            return DirectionTo(head, { path[0] % width, path[0] / width });
+        }
+        failMap = sim.activeMap;
+        failTarget = target;
+        retryTick = sim.ticks + sim.snake.size();
+    }
+    return SafestDirection(sim);
+}
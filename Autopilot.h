@@ -0,0 +1,56 @@
+// Autopilot.h — Bot tự lái: tìm đường BFS tới mồi đang hiện (hoặc cổng khi cổng đã mở)
+//
+// BFS tính theo thời gian: đoạn thân thứ i (tính từ đuôi) rời ô của nó sau i + 1 bước, nên đường
+// đi được phép đi qua ô đó nếu tới nơi muộn hơn. Mọi mảng tìm kiếm cấp phát một lần theo kích thước
+// map, đánh dấu ô bằng số thế hệ thay vì xóa mảng. Khi mục tiêu và map không đổi và rắn đi đúng
+// đường đã tính, các tick sau chỉ đọc bước kế tiếp của đường cũ, không tìm lại.
+// Bàn lớn hơn DENSE_BOARD_CELLS ô không tìm đường, chỉ đi tham về mục tiêu.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "SnakeSim.h"
+
+class Autopilot {
+public:
+    // Hướng cho bước kế tiếp của sim (DIR_*)
+    int NextDirection(const SnakeSim& sim);
+
+    // Quên đường đã tính (ván mới, nạp file)
+    void Reset() { path.clear(); pathPos = 0; pathMap = nullptr; failMap = nullptr; }
+
+    // Thống kê: số lần tìm đường thật sự và số tick dùng lại đường cũ
+    uint64_t searches = 0;
+    uint64_t reuses = 0;
+
+private:
+    int width = 0, height = 0;         // Kích thước các mảng (theo map lớn nhất đã gặp)
+    std::vector<uint32_t> seen;        // seen[cell] == stamp: ô đã vào hàng đợi trong lần tìm này
+    std::vector<int> parent;           // Ô đi tới cell trong cây BFS
+    std::vector<int> depth;            // Số bước từ đầu rắn tới cell
+    std::vector<uint32_t> bodyStamp;   // bodyStamp[cell] == bodyGen: cell đang có thân rắn
+    std::vector<int> bodyIndex;        // Chỉ số đoạn thân tính từ đuôi (0 = đuôi)
+    std::vector<int> queue;
+    uint32_t stamp = 0;                // Thế hệ của mỗi lần duyệt BFS
+    uint32_t bodyGen = 0;              // Thế hệ của mỗi lần đánh dấu thân rắn
+
+    // Đường đã tính: path[0] là ô kế đầu rắn lúc tính, path.back() là mục tiêu
+    std::vector<int> path;
+    size_t pathPos = 0;
+    const MapData* pathMap = nullptr;
+    Point pathTarget{ -1, -1 };
+    uint64_t pathTick = 0;             // sim.ticks khi dùng bước path[pathPos - 1]
+
+    // Mục tiêu không có đường ở lần tìm gần nhất, chưa tìm lại trước tick retryTick
+    const MapData* failMap = nullptr;
+    Point failTarget{ -1, -1 };
+    uint64_t retryTick = 0;
+
+    void Prepare(const SnakeSim& sim);
+    void NewSearch();
+    bool Passable(int cell, int arrive) const;
+    bool FindPath(const SnakeSim& sim, const Point& target);
+    int SafestDirection(const SnakeSim& sim);
+    int CountReachable(const SnakeSim& sim, int start, int limit);
+};
@@ -0,0 +1,360 @@
+// Board.h — Bàn chơi kích thước cố định lúc biên dịch (Board<W, H>) và bộ map dựng sẵn dạng constexpr
+//
+// Board<W, H> là bitmap tường phủ (W + 1) x (H + 1) ô gồm cả viền, ô (x, y) ở bit y * STRIDE + x. Độ rộng
+// hàng, số từ và biên của HitWall đều là hằng số nên trình biên dịch gộp phép nhân chỉ số và bỏ vòng lặp.
+// 5 map mặc định được dựng ngay lúc biên dịch thành BUILTIN_LEVELS (nằm sẵn trong file chạy);
+// InitializeLevelMaps chỉ chép bit tường ra tiles, không dựng lại tường lúc khởi động.
+//
+// FixedBoardSim<W, H> chạy một ván trên bộ map cùng kích thước W x H với trạng thái nóng (thân rắn, bitboard,
+// tập ô trống, ô trống trên cạnh) trong std::array cỡ cố định thay cho RingBuffer/BitGrid/CellSet của
+// SnakeSim. Bước thường (đi, ăn mồi không phải mồi cuối) chạy hết trong các mảng đó; sinh cổng và qua màn
+// chép trạng thái về SnakeSim, gọi SnakeSim::Advance rồi nạp lại, nên kết quả giống hệt SnakeSim::Step.
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "SnakeSim.h"
+
+template <int W, int H>
+struct Board {
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+    static constexpr int STRIDE = W + 1;
+    static constexpr int CELLS = STRIDE * (H + 1);
+    static constexpr int WORDS = (CELLS + 63) / 64;
+
+    uint64_t walls[WORDS] = {};  // Tường trong vùng chơi; viền không lưu
+
+    static constexpr int Index(int x, int y) { return y * STRIDE + x; }
+
+    // Giống SetTile: bỏ qua ô ngoài [0, W) x [0, H)
+    constexpr void SetWall(int x, int y) {
+        if (x < 0 || x >= W || y < 0 || y >= H) return;
+        walls[Index(x, y) >> 6] |= (uint64_t)1 << (Index(x, y) & 63);
+    }
+    constexpr bool Wall(int x, int y) const { return (walls[Index(x, y) >> 6] >> (Index(x, y) & 63)) & 1; }
+
+    // Như IsBlocked: p nằm trong [0, W] x [0, H] (ô kề đầu rắn), chặn nếu là viền hoặc tường
+    constexpr bool HitWall(const Point& p) const {
+        return p.x <= 0 || p.x >= W || p.y <= 0 || p.y >= H || Wall(p.x, p.y);
+    }
+
+    // Bitmap tường của một map W x H bất kỳ (gói màn chơi, map tự dựng)
+    static Board FromMap(const MapData& map) {
+        Board b;
+        for (int y = 1; y < H; y++)
+            for (int x = 1; x < W; x++)
+                if (IsBlocked(map, { x, y })) b.SetWall(x, y);
+        return b;
+    }
+};
+
+// ===== BUILT-IN LEVELS =====
+using ClassicBoard = Board<70, 20>;
+
+struct BuiltinLevel {
+    const char* themeName;
+    int backgroundColor;
+    ClassicBoard board;
+};
+
+// LEVEL 1: PEACEFUL GARDEN — tường đơn giản ở các góc (tránh dòng 5, dòng spawn rắn)
+constexpr ClassicBoard GardenWalls() {
+    ClassicBoard b;
+    for (int i = 5; i <= 10; i++) {
+        b.SetWall(i, 3);
+        b.SetWall(i, 4);
+        b.SetWall(60 + i, 14);  // Góc dưới phải; i = 10 rơi vào viền nên bị bỏ qua như SetTile
+    }
+    return b;
+}
+
+// LEVEL 2: ANCIENT RUINS — các cột đá cổ và tường ngang ở giữa (có lỗ hổng)
+constexpr ClassicBoard RuinsWalls() {
+    ClassicBoard b;
+    for (int y = 6; y <= 8; y++) {
+        b.SetWall(15, y);
+        b.SetWall(55, y);
+    }
+    for (int y = 12; y <= 14; y++) {
+        b.SetWall(25, y);
+        b.SetWall(45, y);
+    }
+    for (int x = 20; x <= 30; x++) b.SetWall(x, 10);
+    for (int x = 40; x <= 50; x++) b.SetWall(x, 10);
+    return b;
+}
+
+// LEVEL 3: CRYSTAL CAVES — mê cung tinh thể hình chữ thập, cột dọc không đi qua dòng 5
+constexpr ClassicBoard CavesWalls() {
+    ClassicBoard b;
+    for (int x = 30; x <= 40; x++) {
+        b.SetWall(x, 7);
+        b.SetWall(x, 13);
+    }
+    for (int y = 2; y <= 4; y++) {
+        b.SetWall(20, y);
+        b.SetWall(50, y);
+    }
+    for (int y = 6; y <= 16; y++) {
+        b.SetWall(20, y);
+        b.SetWall(50, y);
+    }
+    b.SetWall(35, 3);
+    b.SetWall(35, 15);
+    b.SetWall(25, 10);
+    b.SetWall(45, 10);
+    return b;
+}
+
+// LEVEL 4: LAVA TEMPLE — hình kim cương (tránh dòng 5) và tường chắn ở hai cạnh
+constexpr ClassicBoard TempleWalls() {
+    ClassicBoard b;
+    for (int i = 0; i < 10; i++) {
+        if (6 + i != 5) {
+            b.SetWall(35 - i, 6 + i);
+            b.SetWall(35 + i, 6 + i);
+        }
+        if (15 - i != 5) {
+            b.SetWall(35 - i, 15 - i);
+            b.SetWall(35 + i, 15 - i);
+        }
+    }
+    for (int x = 10; x <= 15; x++) {
+        b.SetWall(x, 8);
+        b.SetWall(x, 12);
+        b.SetWall(55 + x - 10, 8);
+        b.SetWall(55 + x - 10, 12);
+    }
+    return b;
+}
+
+// LEVEL 5: NIGHTMARE DIMENSION — 3 lớp hình vuông xoắn ốc (tránh dòng 5) và chướng ngại ở góc
+constexpr ClassicBoard NightmareWalls() {
+    ClassicBoard b;
+    for (int layer = 0; layer < 3; layer++) {
+        int size = 4 + layer * 3;
+        int centerX = 35, centerY = 10;
+        for (int i = 0; i < size; i++) {
+            int topY = centerY - size / 2;
+            int bottomY = centerY + size / 2;
+            int leftX = centerX - size / 2;
+            int rightX = centerX + size / 2;
+            if (topY != 5) b.SetWall(leftX + i, topY);
+            if (bottomY != 5) b.SetWall(leftX + i, bottomY);
+            if (topY + i != 5) b.SetWall(leftX, topY + i);
+            if (topY + i != 5) b.SetWall(rightX, topY + i);
+        }
+    }
+    b.SetWall(10, 3);
+    b.SetWall(11, 3);
+    b.SetWall(60, 17);
+    b.SetWall(59, 17);
+    b.SetWall(65, 6);
+    b.SetWall(65, 7);
+    b.SetWall(5, 14);
+    b.SetWall(5, 15);
+    return b;
+}
+
+// Dựng lúc biên dịch: dữ liệu nằm sẵn trong file chạy, không tốn gì lúc khởi động
+constexpr BuiltinLevel BUILTIN_LEVELS[] = {
+    { "Peaceful Garden", 2, GardenWalls() },      // Xanh lá
+    { "Ancient Ruins", 8, RuinsWalls() },         // Xám
+    { "Crystal Caves", 1, CavesWalls() },         // Xanh dương
+    { "Lava Temple", 4, TempleWalls() },          // Đỏ
+    { "Nightmare Dimension", 5, NightmareWalls() },  // Tím
+};
+const int BUILTIN_LEVEL_COUNT = sizeof(BUILTIN_LEVELS) / sizeof(BUILTIN_LEVELS[0]);
+
+// ===== FIXED-SIZE ENGINE =====
+// CellSet với sức chứa cố định N khóa: cùng thứ tự phần tử sau cùng dãy Insert/Erase (mồi chọn theo vị trí)
+template <int N>
+struct FixedCellSet {
+    std::array<int, N> cells;
+    std::array<int, N> pos;
+    int size = 0;
+
+    void Insert(int key) {
+        if (pos[key] >= 0) return;
+        pos[key] = size;
+        cells[size++] = key;
+    }
+    void Erase(int key) {
+        int i = pos[key];
+        if (i < 0) return;
+        int last = cells[--size];
+        cells[i] = last;
+        pos[last] = i;
+        pos[key] = -1;
+    }
+
+    void CopyFrom(const CellSet& set) {
+        size = set.Size();
+        std::copy(set.cells.begin(), set.cells.end(), cells.begin());
+        std::copy(set.pos.begin(), set.pos.end(), pos.begin());
+    }
+    void CopyTo(CellSet& set) const {
+        set.cells.assign(cells.begin(), cells.begin() + size);
+        set.pos.assign(pos.begin(), pos.end());
+    }
+};
+
+// Dùng cho chạy lại dãy hướng có sẵn (replay, benchmark). Bot đọc SnakeSim mỗi bước thì dùng SnakeSim:
+// State() chép lại thân rắn và tập ô trống, tốn O(W * H)
+template <int W, int H>
+class FixedBoardSim {
+    static_assert((uint64_t)W * H <= (uint64_t)DENSE_BOARD_CELLS, "FixedBoardSim cần tập ô trống dày");
+
+public:
+    using BoardType = Board<W, H>;
+    static constexpr int CELLS = W * H;  // Khóa y * W + x như SnakeSim::freeCells
+
+    // Ván mới như MultiSim::Reset; false (không đổi gì) nếu có map khác kích thước W x H
+    bool Reset(uint64_t seed, int mode = MODE_CLASSIC, bool keepLength = true,
+        const std::vector<MapData>* levels = nullptr) {
+        const std::vector<MapData>& maps = levels ? *levels : DefaultLevelMaps();
+        for (const MapData& map : maps)
+            if (map.width != W || map.height != H) return false;
+        sim.levels = levels;
+        sim.mode = mode;
+        sim.keepLengthWhenLevelUp = keepLength;
+        sim.Reset(seed);
+        Import();
+        return true;
+    }
+
+    // Bắt đầu từ một trạng thái có sẵn (file lưu, bàn dựng cho benchmark); false nếu map khác W x H
+    bool Load(const SnakeSim& state) {
+        if (state.gridWidth != W || state.gridHeight != H) return false;
+        sim = state;
+        Import();
+        return true;
+    }
+
+    // Giống SnakeSim::Step
+    int Step(int dir) {
+        if (!sim.alive) return EVT_DEAD;
+        sim.ticks++;
+
+        const Point& head = body[headIndex];
+        Point nh{ head.x + (dir == DIR_RIGHT) - (dir == DIR_LEFT), head.y + (dir == DIR_DOWN) - (dir == DIR_UP) };
+        if (sim.headOffBoard || board.HitWall(nh) || TestBody(nh)) {
+            sim.alive = false;
+            return EVT_DEAD;
+        }
+
+        bool eat = sim.foodVisible && sim.foodIndex >= 0 && sim.foodIndex < (int)sim.foods.size() &&
+            nh == sim.foods[sim.foodIndex];
+        bool hitGate = sim.gateActive && nh == sim.gatePos;
+        // Mồi cuối (sinh cổng) và qua màn cần rng, sinh mồi, dựng lại map: để SnakeSim làm
+        if (hitGate || (eat && sim.foodIndex == FOOD_COUNT - 1)) {
+            Export();
+            int events = sim.Advance(nh, dir, eat, hitGate);
+            Import();
+            return events;
+        }
+
+        // Như SnakeSim::Advance
+        int events = EVT_MOVED;
+        if (++headIndex == CELLS) headIndex = 0;
+        body[headIndex] = nh;
+        length++;
+        SetBody(nh, true);
+        freeCells.Erase(nh.y * W + nh.x);
+        SetBorderFree(nh, false);
+        if (eat) {
+            events |= EVT_EAT;
+            sim.score += sim.speedLevel * 10;
+            sim.foodIndex++;
+        }
+        else {
+            Point tail = body[start];
+            if (++start == CELLS) start = 0;
+            length--;
+            // Đoạn nằm ngoài map (rắn quá dài khi qua màn) không có trong bitboard
+            if (tail.x >= 0 && tail.x < W && tail.y >= 0 && tail.y < H) {
+                SetBody(tail, false);
+                if (!board.HitWall(tail)) {
+                    freeCells.Insert(tail.y * W + tail.x);
+                    SetBorderFree(tail, true);
+                }
+            }
+        }
+        if (length > 2) sim.locked = dir ^ 1;
+        sim.moving = dir;
+        return events;
+    }
+
+    // Trạng thái đầy đủ dạng SnakeSim (lưu file, vẽ, so sánh): chép thân rắn, bitboard và các tập ô trống
+    const SnakeSim& State() {
+        Export();
+        return sim;
+    }
+    bool Alive() const { return sim.alive; }
+    uint64_t Ticks() const { return sim.ticks; }
+    Point Head() const { return body[headIndex]; }
+
+private:
+    SnakeSim sim;  // Mọi trường ngoài thân rắn/bitboard/tập ô trống luôn đúng; các trường đó đúng sau Export
+    BoardType board;                       // Tường của map hiện tại
+    std::array<Point, CELLS> body;         // Thân rắn, vòng: body[start] là đuôi, body[headIndex] là đầu
+    int start = 0, headIndex = 0, length = 0;
+    std::array<uint64_t, BoardType::WORDS> occupied;  // Bit y * STRIDE + x cho mỗi đoạn thân trong bàn
+    FixedCellSet<CELLS> freeCells;
+    FixedCellSet<W> borderRows[2];         // Cạnh trên/dưới, khóa x
+    FixedCellSet<H> borderCols[2];         // Cạnh trái/phải, khóa y
+
+    bool TestBody(const Point& p) const {
+        int i = BoardType::Index(p.x, p.y);
+        return (occupied[i >> 6] >> (i & 63)) & 1;
+    }
+    void SetBody(const Point& p, bool value) {
+        int i = BoardType::Index(p.x, p.y);
+        if (value) occupied[i >> 6] |= (uint64_t)1 << (i & 63);
+        else occupied[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    }
+    void SetBorderFree(const Point& p, bool free) {
+        if (p.y == 1)     free ? borderRows[0].Insert(p.x) : borderRows[0].Erase(p.x);
+        if (p.y == H - 1) free ? borderRows[1].Insert(p.x) : borderRows[1].Erase(p.x);
+        if (p.x == 1)     free ? borderCols[0].Insert(p.y) : borderCols[0].Erase(p.y);
+        if (p.x == W - 1) free ? borderCols[1].Insert(p.y) : borderCols[1].Erase(p.y);
+    }
+
+    // SnakeSim -> mảng cố định (sau Reset, qua màn, sinh cổng): O(W * H)
+    void Import() {
+        board = BoardType::FromMap(*sim.activeMap);
+        occupied.fill(0);
+        start = 0;
+        length = (int)sim.snake.size();
+        headIndex = length - 1;
+        for (int i = 0; i < length; i++) {
+            body[i] = sim.snake[i];
+            const Point& p = body[i];
+            if (p.x >= 0 && p.x < W && p.y >= 0 && p.y < H) SetBody(p, true);
+        }
+        freeCells.CopyFrom(sim.freeCells);
+        borderRows[0].CopyFrom(sim.borderFree[0]);
+        borderRows[1].CopyFrom(sim.borderFree[1]);
+        borderCols[0].CopyFrom(sim.borderFree[2]);
+        borderCols[1].CopyFrom(sim.borderFree[3]);
+    }
+
+    // Mảng cố định -> SnakeSim
+    void Export() {
+        sim.snake.clear();
+        sim.occupancy.Reset(W, H, true);
+        for (int i = 0; i < length; i++) {
+            const Point& p = body[(start + i) % CELLS];
+            sim.snake.push_back(p);
+            if (p.x >= 0 && p.x < W && p.y >= 0 && p.y < H) sim.occupancy.Set(p.x, p.y);
+        }
+        freeCells.CopyTo(sim.freeCells);
+        borderRows[0].CopyTo(sim.borderFree[0]);
+        borderRows[1].CopyTo(sim.borderFree[1]);
+        borderCols[0].CopyTo(sim.borderFree[2]);
+        borderCols[1].CopyTo(sim.borderFree[3]);
+    }
+};
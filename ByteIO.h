@@ -0,0 +1,74 @@
+// ByteIO.h — Ghi/đọc số nguyên little-endian và checksum cho các định dạng file nhị phân
+// Dùng chung cho snapshot ván chơi (SnakeSave) và chỉ mục bảng xếp hạng (HighScoreStore)
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// h: tiếp tục từ kết quả của đoạn trước khi băm nhiều đoạn nối nhau
+inline uint32_t Fnv1a(const uint8_t* data, size_t size, uint32_t h = 2166136261u) {
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Ghi số nguyên little-endian, không phụ thuộc thứ tự byte của máy
+struct ByteWriter {
+    std::vector<uint8_t>& buf;
+    void U8(uint32_t v) { buf.push_back((uint8_t)v); }
+    void U16(uint32_t v) { U8(v); U8(v >> 8); }
+    void U32(uint32_t v) { U16(v); U16(v >> 16); }
+    void U64(uint64_t v) { U32((uint32_t)v); U32((uint32_t)(v >> 32)); }
+    // Chuỗi ngắn: 1 byte độ dài (cắt ở 255) + nội dung
+    void Str(const std::string& s) {
+        size_t n = s.size() < 255 ? s.size() : 255;
+        U8((uint32_t)n);
+        buf.insert(buf.end(), s.begin(), s.begin() + n);
+    }
+    // Varint LEB128: 7 bit mỗi byte, bit cao = còn byte tiếp theo
+    void Var(uint64_t v) {
+        while (v >= 0x80) { U8((uint32_t)(v & 0x7f) | 0x80); v >>= 7; }
+        U8((uint32_t)v);
+    }
+    void Put32(size_t at, uint32_t v) {
+        for (int i = 0; i < 4; i++) buf[at + i] = (uint8_t)(v >> (8 * i));
+    }
+};
+
+// Đọc có kiểm tra biên: đọc quá cuối trả về 0 và đặt ok = false
+struct ByteReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool ok = true;
+
+    uint32_t U8() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    uint32_t U16() { uint32_t lo = U8(); return lo | (U8() << 8); }
+    uint32_t U32() { uint32_t lo = U16(); return lo | (U16() << 16); }
+    uint64_t U64() { uint64_t lo = U32(); return lo | ((uint64_t)U32() << 32); }
+    std::string Str() {
+        size_t n = U8();
+        if (Left() < n) { ok = false; p = end; return std::string(); }
+        std::string s((const char*)p, n);
+        p += n;
+        return s;
+    }
+    uint64_t Var() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint32_t b = U8();
+            v |= (uint64_t)(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false; // Quá 10 byte: dữ liệu hỏng
+        return 0;
+    }
+    size_t Left() const { return (size_t)(end - p); }
+};
@@ -0,0 +1,39 @@
+// CellSet.h — Tập ô đánh chỉ số (mảng dày + chỉ số vị trí, xóa bằng cách đổi chỗ với phần tử cuối)
+// Thêm, xóa, kiểm tra và lấy ngẫu nhiên một phần tử đều O(1)
+
+#pragma once
+
+#include <vector>
+
+struct CellSet {
+    std::vector<int> cells;  // Các khóa đang có trong tập, không theo thứ tự
+    std::vector<int> pos;    // pos[key] = vị trí của key trong cells, -1 nếu không có
+
+    // Tạo tập rỗng cho các khóa 0..keyCount-1
+    void Reset(int keyCount) {
+        cells.clear();
+        cells.reserve(keyCount);
+        pos.assign(keyCount, -1);
+    }
+
+    int Size() const { return (int)cells.size(); }
+    bool Empty() const { return cells.empty(); }
+    int At(int i) const { return cells[i]; }
+    bool Contains(int key) const { return pos[key] >= 0; }
+
+    void Insert(int key) {
+        if (pos[key] >= 0) return;
+        pos[key] = (int)cells.size();
+        cells.push_back(key);
+    }
+
+    void Erase(int key) {
+        int i = pos[key];
+        if (i < 0) return;
+        int last = cells.back();
+        cells[i] = last;
+        pos[last] = i;
+        cells.pop_back();
+        pos[key] = -1;
+    }
+};
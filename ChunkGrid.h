@@ -0,0 +1,233 @@
+// ChunkGrid.h — Lưới ô thưa chia khối 64x64 cho bàn chơi rất lớn (tới 65535 x 65535)
+//
+// Bảng khối (một con trỏ cho mỗi 64x64 ô) trỏ tới khối thật; khối chưa ghi trỏ vào khối mặc định
+// dùng chung, nên đọc một ô luôn là hai lần đọc bộ nhớ, không rẽ nhánh. Khối chỉ được cấp
+// phát khi có ô khác mặc định (tường, viền, thân rắn), khối trả lại được dùng lại cho lần cấp sau:
+// bộ nhớ theo nội dung, không theo diện tích.
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+const int CHUNK_SHIFT = 6;
+const int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+const int CHUNK_MASK = CHUNK_SIZE - 1;
+
+template <typename Chunk>
+class ChunkGrid {
+public:
+    ChunkGrid() = default;
+    ChunkGrid(ChunkGrid&&) = default;
+    ChunkGrid& operator=(ChunkGrid&&) = default;
+    // Chép sâu: bảng khối của bản sao trỏ vào khối của chính nó
+    ChunkGrid(const ChunkGrid& o) { *this = o; }
+    ChunkGrid& operator=(const ChunkGrid& o) {
+        if (this == &o) return *this;
+        chunksX = o.chunksX;
+        chunksY = o.chunksY;
+        empty = o.empty ? std::make_unique<Chunk>(*o.empty) : nullptr;
+        store.clear();
+        released.clear();
+        directory.assign(o.directory.size(), empty.get());
+        for (size_t i = 0; i < o.directory.size(); i++) {
+            if (o.directory[i] == o.empty.get()) continue;
+            store.push_back(std::make_unique<Chunk>(*o.directory[i]));
+            directory[i] = store.back().get();
+        }
+        return *this;
+    }
+
+    // Lưới width x height ô, mọi ô mang giá trị của khối fill
+    void Reset(int width, int height, const Chunk& fill) {
+        chunksX = (width + CHUNK_MASK) >> CHUNK_SHIFT;
+        chunksY = (height + CHUNK_MASK) >> CHUNK_SHIFT;
+        empty = std::make_unique<Chunk>(fill);
+        store.clear();
+        released.clear();
+        directory.assign((size_t)chunksX * chunksY, empty.get());
+    }
+
+    // (x, y) phải nằm trong lưới
+    const Chunk& Read(int x, int y) const { return *directory[Slot(x, y)]; }
+
+    // Khối chứa (x, y) để ghi; cấp phát (chép khối mặc định) nếu chưa có
+    Chunk& Write(int x, int y) {
+        Chunk*& c = directory[Slot(x, y)];
+        if (c == empty.get()) c = Allocate();
+        return *c;
+    }
+
+    // Khối chứa (x, y) để ghi nếu đã cấp phát, nullptr nếu ô đang mang giá trị mặc định
+    Chunk* WriteExisting(int x, int y) {
+        Chunk* c = directory[Slot(x, y)];
+        return c == empty.get() ? nullptr : c;
+    }
+
+    // Trả khối chứa (x, y) về giá trị mặc định (khi nó không còn ô nào khác mặc định)
+    void Release(int x, int y) {
+        Chunk*& c = directory[Slot(x, y)];
+        if (c == empty.get()) return;
+        *c = *empty;
+        released.push_back(c);
+        c = empty.get();
+    }
+
+    // Khối thứ (cx, cy) theo đơn vị khối; nullptr nếu chưa cấp phát
+    const Chunk* Find(int cx, int cy) const {
+        const Chunk* c = directory[(size_t)cy * chunksX + cx];
+        return c == empty.get() ? nullptr : c;
+    }
+
+    int ChunksX() const { return chunksX; }
+    int ChunksY() const { return chunksY; }
+    size_t AllocatedChunks() const { return store.size() - released.size(); }
+    size_t MemoryBytes() const {
+        return directory.capacity() * sizeof(Chunk*) + (store.size() + 1) * sizeof(Chunk) +
+            (store.capacity() + released.capacity()) * sizeof(Chunk*);
+    }
+
+private:
+    int chunksX = 0, chunksY = 0;
+    std::unique_ptr<Chunk> empty;              // Khối mặc định dùng chung, không bao giờ ghi
+    std::vector<Chunk*> directory;             // directory[cy * chunksX + cx], empty nếu chưa cấp phát
+    std::vector<std::unique_ptr<Chunk>> store; // Mọi khối đã cấp phát (địa chỉ cố định)
+    std::vector<Chunk*> released;              // Khối đã trả, cấp lại trước khi cấp phát mới
+
+    size_t Slot(int x, int y) const { return (size_t)(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT); }
+
+    Chunk* Allocate() {
+        if (!released.empty()) {
+            Chunk* c = released.back();
+            released.pop_back();
+            return c;
+        }
+        store.push_back(std::make_unique<Chunk>(*empty));
+        return store.back().get();
+    }
+};
+
+// Một byte mỗi ô (ký hiệu ô bản đồ)
+struct TileChunk {
+    char cells[CHUNK_SIZE * CHUNK_SIZE];
+};
+
+// Bàn nhỏ (dense) giữ mảng liền, ô y * width + x; bàn lớn dùng khối thưa
+class TileGrid {
+public:
+    void Reset(int w, int h, char fill, bool dense) {
+        flat.assign(dense ? (size_t)w * h : 0, fill);
+        if (dense) grid = ChunkGrid<TileChunk>();
+        else {
+            TileChunk empty;
+            for (char& c : empty.cells) c = fill;
+            grid.Reset(w, h, empty);
+        }
+        width = w;
+        height = h;
+        flatWidth = dense ? w : 0;
+    }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    char Get(int x, int y) const {
+        if (flatWidth) return flat[(size_t)y * flatWidth + x];
+        return grid.Read(x, y).cells[Cell(x, y)];
+    }
+    void Set(int x, int y, char tile) {
+        if (flatWidth) flat[(size_t)y * flatWidth + x] = tile;
+        else if (Get(x, y) != tile) grid.Write(x, y).cells[Cell(x, y)] = tile;
+    }
+
+    // Khối thưa, chỉ dùng khi Reset với dense = false
+    const ChunkGrid<TileChunk>& Chunks() const { return grid; }
+    size_t MemoryBytes() const { return flat.capacity() + grid.MemoryBytes(); }
+
+private:
+    std::vector<char> flat;
+    int flatWidth = 0;  // 0: đang dùng khối thưa
+    ChunkGrid<TileChunk> grid;
+    int width = 0, height = 0;
+
+    static int Cell(int x, int y) { return ((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK); }
+};
+
+// Một bit mỗi ô: mỗi khối 64 hàng, hàng là một từ 64 bit (bit x & 63)
+struct BitChunk {
+    uint64_t rows[CHUNK_SIZE];
+    int count;  // Số bit đang bật, về 0 thì khối được trả lại
+};
+
+// Bàn nhỏ (dense) giữ bitboard liền một mảng, bit y * width + x: một lần đọc mỗi ô, không đếm
+// khối; bàn lớn dùng khối thưa
+class BitGrid {
+public:
+    void Reset(int width, int height, bool dense) {
+        flatWidth = dense ? width : 0;
+        flat.assign(dense ? ((size_t)width * height + 63) / 64 : 0, 0);
+        if (dense) grid = ChunkGrid<BitChunk>();
+        else grid.Reset(width, height, BitChunk{});
+    }
+
+    bool Test(int x, int y) const {
+        if (flatWidth) {
+            size_t i = (size_t)y * flatWidth + x;
+            return (flat[i >> 6] >> (i & 63)) & 1;
+        }
+        return (grid.Read(x, y).rows[y & CHUNK_MASK] >> (x & CHUNK_MASK)) & 1;
+    }
+
+    // Trả về true nếu bit đã đổi
+    bool Set(int x, int y) {
+        if (flatWidth) {
+            size_t i = (size_t)y * flatWidth + x;
+            uint64_t bit = (uint64_t)1 << (i & 63);
+            bool changed = !(flat[i >> 6] & bit);
+            flat[i >> 6] |= bit;
+            return changed;
+        }
+        uint64_t bit = (uint64_t)1 << (x & CHUNK_MASK);
+        BitChunk& c = grid.Write(x, y);
+        uint64_t& row = c.rows[y & CHUNK_MASK];
+        if (row & bit) return false;
+        row |= bit;
+        c.count++;
+        return true;
+    }
+
+    bool Clear(int x, int y) {
+        if (flatWidth) {
+            size_t i = (size_t)y * flatWidth + x;
+            uint64_t bit = (uint64_t)1 << (i & 63);
+            bool changed = (flat[i >> 6] & bit) != 0;
+            flat[i >> 6] &= ~bit;
+            return changed;
+        }
+        BitChunk* c = grid.WriteExisting(x, y);
+        if (!c) return false;
+        uint64_t bit = (uint64_t)1 << (x & CHUNK_MASK);
+        uint64_t& row = c->rows[y & CHUNK_MASK];
+        if (!(row & bit)) return false;
+        row &= ~bit;
+        if (--c->count == 0) grid.Release(x, y);
+        return true;
+    }
+
+    // Từ chứa bit (x, y), để nạp trước vào cache
+    const uint64_t* Row(int x, int y) const {
+        if (flatWidth) return &flat[((size_t)y * flatWidth + x) >> 6];
+        return &grid.Read(x, y).rows[y & CHUNK_MASK];
+    }
+
+    // Khối thưa, chỉ dùng khi Reset với dense = false
+    const ChunkGrid<BitChunk>& Chunks() const { return grid; }
+    size_t MemoryBytes() const { return flat.capacity() * sizeof(uint64_t) + grid.MemoryBytes(); }
+
+private:
+    std::vector<uint64_t> flat;
+    int flatWidth = 0;  // 0: đang dùng khối thưa
+    ChunkGrid<BitChunk> grid;
+};
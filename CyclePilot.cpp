@@ -0,0 +1,99 @@
+// CyclePilot.cpp — Cài đặt bot theo chu trình Hamilton
+
+#include "CyclePilot.h"
+
+using namespace std;
+
+static int DirectionTo(const Point& from, const Point& to) {
+    if (to.x < from.x) return DIR_LEFT;
+    if (to.x > from.x) return DIR_RIGHT;
+    if (to.y < from.y) return DIR_UP;
+    return DIR_DOWN;
+}
+
+// Số bước đi dọc chu trình từ vị trí a tới vị trí b
+static int CycleDistance(int a, int b, int n) {
+    return b >= a ? b - a : b - a + n;
+}
+
+// Thân rắn từ đuôi tới đầu đi tiến dọc chu trình và không vòng qua chính nó
+bool CyclePilot::Ordered(const SnakeSim& sim, const MapData& map) const {
+    int n = (int)map.cycleCells.size();
+    int total = 0, prev = -1;
+    for (const Point& p : sim.snake) {
+        if (p.x <= 0 || p.x >= sim.gridWidth || p.y <= 0 || p.y >= sim.gridHeight) return false;
+        int k = map.cycleOrder[p.y * sim.gridWidth + p.x];
+        if (k < 0) return false;
+        if (prev >= 0) {
+            int d = CycleDistance(prev, k, n);
+            if (d == 0) return false;
+            total += d;
+        }
+        prev = k;
+    }
+    return total < n;
+}
+
+int CyclePilot::NextDirection(const SnakeSim& sim) {
+    if (!sim.alive || sim.snake.empty() || sim.headOffBoard) return sim.moving;
+    const MapData& map = *sim.activeMap;
+    int n = (int)map.cycleCells.size();
+    if (n == 0) {
+        fallbackMoves++;
+        return fallback.NextDirection(sim);
+    }
+
+    const Point& head = sim.snake.back();
+    int headCell = head.y * sim.gridWidth + head.x;
+    // Bước trước do bot này chọn và giữ thứ tự: không cần kiểm tra lại toàn bộ thân
+    bool ordered = (lastMap == &map && sim.ticks == lastTick + 1 && headCell == lastCell) || Ordered(sim, map);
+    lastMap = nullptr;
+    if (!ordered) {
+        // Chưa theo chu trình: đi theo chu trình nếu ô kế tiếp trống, sau đủ số bước thân sẽ nằm theo
+        int next = map.cycleCells[(map.cycleOrder[headCell] + 1) % n];
+        Point p{ next % sim.gridWidth, next / sim.gridWidth };
+        int dir = DirectionTo(head, p);
+        fallbackMoves++;
+        if (!sim.HitSelf(p) && CanChangeDirection(dir, sim.moving, sim.snake.size())) return dir;
+        return fallback.NextDirection(sim);
+    }
+
+    const Point& tail = sim.snake.front();
+    int headPos = map.cycleOrder[headCell];
+    int tailDist = CycleDistance(headPos, map.cycleOrder[tail.y * sim.gridWidth + tail.x], n);
+
+    bool food = sim.foodVisible && sim.foodIndex >= 0 && sim.foodIndex < (int)sim.foods.size();
+    Point target = food ? sim.foods[sim.foodIndex] : sim.gatePos;
+    // Mục tiêu ngoài vùng chơi hoặc không nằm trên chu trình (trạng thái sửa từ bên ngoài): chỉ bám chu trình
+    bool onBoard = target.x > 0 && target.x < sim.gridWidth && target.y > 0 && target.y < sim.gridHeight;
+    int targetPos = (food || sim.gateActive) && onBoard ? map.cycleOrder[target.y * sim.gridWidth + target.x] : -1;
+    int targetDist = targetPos >= 0 ? CycleDistance(headPos, targetPos, n) : 1;
+
+    // Mặc định đi ô kế tiếp trên chu trình; đi tắt xa nhất có thể mà không vượt mục tiêu và còn chừa
+    // chỗ trước đuôi cho phần thân dài thêm khi ăn
+    bool shortcut = sim.snake.size() < shortcutLimit * n;
+    int best = -1, bestDist = 0;
+    for (int dir = 0; dir < 4; dir++) {
+        if (!CanChangeDirection(dir, sim.moving, sim.snake.size())) continue;
+        Point p = sim.NextHead(dir);
+        if (sim.HitWall(p) || sim.HitSelf(p)) continue;
+        int d = CycleDistance(headPos, map.cycleOrder[p.y * sim.gridWidth + p.x], n);
+        if (d == 0 || d >= tailDist) continue;
+        if (d != 1 && (!shortcut || d > targetDist || d + 4 >= tailDist)) continue;
+        if (d > bestDist) {
+            best = dir;
+            bestDist = d;
+        }
+    }
+    if (best < 0) {
+        fallbackMoves++;
+        return fallback.NextDirection(sim);
+    }
+
+    cycleMoves++;
+    lastMap = &map;
+    lastTick = sim.ticks;
+    Point p = sim.NextHead(best);
+    lastCell = p.y * sim.gridWidth + p.x;
+    return best;
+}
@@ -0,0 +1,34 @@
+// CyclePilot.h — Bot "không bao giờ chết": đi theo chu trình Hamilton của map, đi tắt khi an toàn
+//
+// Khi thân rắn nằm theo thứ tự trên chu trình (đuôi -> đầu), đi tiếp theo chu trình không bao giờ
+// đâm vào thân. Đi tắt tới ô kề khác được phép nếu ô đó vẫn nằm trước đuôi trên chu trình (chừa chỗ
+// cho phần thân mọc thêm) và không vượt qua mục tiêu. Map không có chu trình hoặc thân rắn chưa
+// nằm theo chu trình (vừa qua màn, vừa nạp file) thì dùng Autopilot.
+
+#pragma once
+
+#include <cstdint>
+#include "SnakeSim.h"
+#include "Autopilot.h"
+
+class CyclePilot {
+public:
+    int NextDirection(const SnakeSim& sim);
+    void Reset() { fallback.Reset(); lastMap = nullptr; }
+
+    // Chỉ đi tắt khi rắn còn ngắn hơn tỉ lệ này của số ô trống; dài hơn thì bám chu trình
+    double shortcutLimit = 0.5;
+
+    uint64_t cycleMoves = 0;     // Số bước đi theo chu trình (kể cả đi tắt)
+    uint64_t fallbackMoves = 0;  // Số bước giao cho Autopilot
+
+private:
+    Autopilot fallback;
+
+    // Thân rắn nằm theo chu trình ở tick trước và bước vừa đi giữ nguyên thứ tự đó
+    const MapData* lastMap = nullptr;
+    uint64_t lastTick = 0;
+    int lastCell = -1;
+
+    bool Ordered(const SnakeSim& sim, const MapData& map) const;
+};
@@ -0,0 +1,58 @@
+// FrameBuffer.h — Bộ đệm khung hình console hai lớp (back/front) để chỉ ghi các ô thay đổi
+// Không phụ thuộc nền tảng; phần ghi ra màn hình do frontend đảm nhận
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+struct ScreenCell {
+    char ch;
+    uint8_t color;
+};
+
+inline bool operator==(const ScreenCell& a, const ScreenCell& b) { return a.ch == b.ch && a.color == b.color; }
+inline bool operator!=(const ScreenCell& a, const ScreenCell& b) { return !(a == b); }
+
+struct FrameBuffer {
+    int width = 0, height = 0;
+    std::vector<ScreenCell> back;   // Khung hình đang dựng
+    std::vector<ScreenCell> front;  // Nội dung đang hiển thị trên màn hình
+
+    // Đổi kích thước; lần ghi kế tiếp sẽ vẽ lại toàn bộ
+    void Resize(int w, int h) {
+        width = w; height = h;
+        back.assign((size_t)w * h, ScreenCell{ ' ', 7 });
+        Invalidate();
+    }
+
+    // Màn hình đã bị ghi đè từ bên ngoài (cls, menu, ...): coi như mọi ô đều khác
+    void Invalidate() {
+        front.assign((size_t)width * height, ScreenCell{ 0, 0 });
+    }
+
+    void Clear() {
+        for (auto& c : back) c = ScreenCell{ ' ', 7 };
+    }
+
+    void SetCell(int x, int y, char ch, int color = 7) {
+        if (x < 0 || x >= width || y < 0 || y >= height) return;
+        back[(size_t)y * width + x] = ScreenCell{ ch, (uint8_t)color };
+    }
+
+    void SetText(int x, int y, const std::string& text, int color = 7) {
+        for (size_t i = 0; i < text.size(); i++) SetCell(x + (int)i, y, text[i], color);
+    }
+
+    // Lấy chỉ số các ô khác với màn hình và đánh dấu chúng là đã hiển thị
+    void CollectChanges(std::vector<int>& changed) {
+        changed.clear();
+        for (size_t i = 0; i < back.size(); i++) {
+            if (back[i] != front[i]) {
+                changed.push_back((int)i);
+                front[i] = back[i];
+            }
+        }
+    }
+};
@@ -0,0 +1,234 @@
+// HighScoreStore.cpp — Cài đặt bảng xếp hạng có chỉ mục
+
+#include <algorithm>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include "HighScoreStore.h"
+#include "MappedFile.h"
+#include "ByteIO.h"
+
+using namespace std;
+
+static const uint8_t INDEX_MAGIC[4] = { 'S', 'N', 'K', 'H' };
+static const uint16_t INDEX_VERSION = 1;
+static const size_t INDEX_HEADER_SIZE = 16;
+
+// ===== PARSING =====
+static bool ParseInt(const string& s, int& value) {
+    if (s.empty()) return false;
+    errno = 0;
+    char* end = nullptr;
+    long v = strtol(s.c_str(), &end, 10);
+    if (errno != 0 || end != s.c_str() + s.size() || v < INT_MIN || v > INT_MAX) return false;
+    value = (int)v;
+    return true;
+}
+
+bool ParseHighScoreLine(const string& line, HighScoreEntry& entry) {
+    size_t pos1 = line.find('|');
+    if (pos1 == string::npos) return false;
+    size_t pos2 = line.find('|', pos1 + 1);
+    if (pos2 == string::npos) return false;
+    size_t pos3 = line.find('|', pos2 + 1);
+    if (pos3 == string::npos) return false;
+
+    int score, level;
+    if (!ParseInt(line.substr(pos1 + 1, pos2 - pos1 - 1), score)) return false;
+    if (!ParseInt(line.substr(pos2 + 1, pos3 - pos2 - 1), level)) return false;
+
+    string date = line.substr(pos3 + 1);
+    if (!date.empty() && date.back() == '\r') date.pop_back(); // Nhật ký ghi ở chế độ text trên Windows
+    entry = HighScoreEntry(line.substr(0, pos1), score, level, date);
+    return true;
+}
+
+// ===== IN-MEMORY INDEX =====
+void HighScoreStore::Insert(const HighScoreEntry& entry) {
+    // upper_bound: bằng điểm thì đứng sau các lần chơi trước (thứ tự ổn định)
+    auto it = upper_bound(top.begin(), top.end(), entry, [](const HighScoreEntry& a, const HighScoreEntry& b) {
+        return a.score > b.score;
+        });
+    if (it != top.end() || (int)top.size() < HIGHSCORE_TOP_K) {
+        top.insert(it, entry);
+        if ((int)top.size() > HIGHSCORE_TOP_K) top.pop_back();
+    }
+
+    auto found = best.find(entry.playerName);
+    if (found == best.end()) best.emplace(entry.playerName, entry);
+    else if (entry.score > found->second.score) found->second = entry;
+}
+
+// Đưa phần nhật ký từ logBytes tới cuối file vào chỉ mục; chỉ nhận dòng đã có '\n'
+void HighScoreStore::CatchUp(uint64_t fileSize) {
+    if (logBytes >= fileSize) return;
+    MappedFile file;
+    if (!file.Open(logPath)) return;
+
+    const char* data = (const char*)file.data;
+    size_t pos = (size_t)logBytes;
+    while (pos < file.size) {
+        const char* nl = (const char*)memchr(data + pos, '\n', file.size - pos);
+        if (!nl) break; // Dòng cuối chưa ghi xong
+        string line(data + pos, nl);
+        HighScoreEntry entry;
+        if (ParseHighScoreLine(line, entry)) Insert(entry); // Dòng hỏng bị bỏ qua
+        pos = (size_t)(nl - data) + 1;
+    }
+    logBytes = pos;
+}
+
+// ===== INDEX FILE =====
+bool HighScoreStore::LoadIndex() {
+    MappedFile file;
+    if (!file.Open(indexPath) || file.size < INDEX_HEADER_SIZE) return false;
+    if (!equal(INDEX_MAGIC, INDEX_MAGIC + 4, file.data)) return false;
+
+    ByteReader h{ file.data + 4, file.data + INDEX_HEADER_SIZE };
+    uint32_t version = h.U16();
+    uint32_t headerSize = h.U16();
+    uint32_t payloadSize = h.U32();
+    uint32_t checksum = h.U32();
+    if (version != INDEX_VERSION || headerSize != INDEX_HEADER_SIZE) return false;
+    if (payloadSize != file.size - headerSize) return false;
+    if (Fnv1a(file.data + headerSize, payloadSize) != checksum) return false;
+
+    ByteReader r{ file.data + headerSize, file.data + file.size };
+    auto readEntry = [&r]() {
+        HighScoreEntry e;
+        e.playerName = r.Str();
+        e.score = (int)r.U32();
+        e.level = (int)r.U32();
+        e.date = r.Str();
+        return e;
+    };
+
+    uint64_t bytes = r.U64();
+    uint32_t topCount = r.U32();
+    if (topCount > (uint32_t)HIGHSCORE_TOP_K) return false;
+    vector<HighScoreEntry> newTop;
+    for (uint32_t i = 0; i < topCount && r.ok; i++) newTop.push_back(readEntry());
+
+    uint32_t playerCount = r.U32();
+    if (playerCount > r.Left()) return false; // Mỗi người chơi chiếm ít nhất 10 byte
+    unordered_map<string, HighScoreEntry> newBest;
+    newBest.reserve(playerCount);
+    for (uint32_t i = 0; i < playerCount && r.ok; i++) {
+        HighScoreEntry e = readEntry();
+        newBest[e.playerName] = e;
+    }
+    if (!r.ok || r.Left() != 0) return false;
+
+    logBytes = bytes;
+    top.swap(newTop);
+    best.swap(newBest);
+    return true;
+}
+
+void HighScoreStore::SaveIndex() {
+    vector<uint8_t> buf;
+    ByteWriter w{ buf };
+    for (uint8_t c : INDEX_MAGIC) w.U8(c);
+    w.U16(INDEX_VERSION);
+    w.U16((uint32_t)INDEX_HEADER_SIZE);
+    w.U32(0);
+    w.U32(0);
+
+    auto writeEntry = [&w](const HighScoreEntry& e) {
+        w.Str(e.playerName);
+        w.U32((uint32_t)e.score);
+        w.U32((uint32_t)e.level);
+        w.Str(e.date);
+    };
+    w.U64(logBytes);
+    w.U32((uint32_t)top.size());
+    for (auto& e : top) writeEntry(e);
+    w.U32((uint32_t)best.size());
+    for (auto& kv : best) writeEntry(kv.second);
+
+    size_t payloadSize = buf.size() - INDEX_HEADER_SIZE;
+    w.Put32(8, (uint32_t)payloadSize);
+    w.Put32(12, Fnv1a(buf.data() + INDEX_HEADER_SIZE, payloadSize));
+
+    ofstream fo(indexPath, ios::binary | ios::trunc);
+    fo.write((const char*)buf.data(), (streamsize)buf.size());
+    if (fo) savedBytes = logBytes;
+}
+
+// ===== PUBLIC =====
+bool HighScoreStore::Open(const string& path, const string& idxPath) {
+    Close();
+    logPath = path;
+    indexPath = idxPath.empty() ? path + ".idx" : idxPath;
+    top.clear();
+    best.clear();
+    logBytes = 0;
+
+    uint64_t fileSize = 0;
+    {
+        ifstream in(logPath, ios::binary | ios::ate);
+        if (in) fileSize = (uint64_t)in.tellg();
+    }
+
+    // Nhật ký bị thay/cắt ngắn so với chỉ mục: quét lại từ đầu
+    if (!LoadIndex() || logBytes > fileSize) {
+        top.clear();
+        best.clear();
+        logBytes = 0;
+    }
+    savedBytes = logBytes;
+    CatchUp(fileSize);
+    if (logBytes != savedBytes || fileSize == 0) SaveIndex();
+
+    log.open(logPath, ios::binary | ios::app);
+    return (bool)log;
+}
+
+bool HighScoreStore::Add(const HighScoreEntry& entry) {
+    if (!log) return false;
+    // '|' và xuống dòng trong tên sẽ làm hỏng dòng nhật ký
+    HighScoreEntry clean = entry;
+    for (char& c : clean.playerName) if (c == '|' || c == '\n' || c == '\r') c = ' ';
+    string line = clean.playerName + "|" + to_string(clean.score) + "|" + to_string(clean.level) + "|" + clean.date + "\n";
+
+    // Cuối file thật chứ không phải logBytes: dòng cuối có thể ghi dở (chương trình bị ngắt giữa chừng)
+    // hoặc tiến trình khác vừa ghi thêm. Nhận các dòng đủ trước, phần dở dang thì xuống dòng rồi mới ghi
+    log.seekp(0, ios::end);
+    streamoff end = log.tellp();
+    if (end < 0) return false;
+    CatchUp((uint64_t)end);
+    bool partial = logBytes < (uint64_t)end;
+    if (partial) line.insert(line.begin(), '\n');
+    log << line;
+    log.flush();
+    if (!log) return false;
+
+    uint64_t newEnd = (uint64_t)end + line.size();
+    if (partial) {
+        // Dòng dở giờ đã có '\n': đọc nó như lần quét lại từ đầu sẽ đọc, cùng với dòng vừa ghi
+        CatchUp(newEnd);
+        return true;
+    }
+    logBytes = newEnd;
+    Insert(clean);
+    return true;
+}
+
+void HighScoreStore::Close() {
+    if (!log.is_open()) return;
+    log.close();
+    if (logBytes != savedBytes) SaveIndex();
+}
+
+vector<HighScoreEntry> HighScoreStore::Top(int n) const {
+    n = max(0, min(n, (int)top.size()));
+    return vector<HighScoreEntry>(top.begin(), top.begin() + n);
+}
+
+bool HighScoreStore::PlayerBest(const string& name, HighScoreEntry& result) const {
+    auto found = best.find(name);
+    if (found == best.end()) return false;
+    result = found->second;
+    return true;
+}
@@ -0,0 +1,63 @@
+// HighScoreStore.h — Bảng xếp hạng: nhật ký text chỉ ghi thêm + chỉ mục nhị phân nhỏ đi kèm
+//
+// highscores.txt giữ toàn bộ lịch sử "tên|điểm|level|ngày" như trước (chỉ append).
+// highscores.txt.idx (tên nhật ký + ".idx") lưu top-K đã sắp xếp, điểm cao nhất của từng người chơi
+// và số byte nhật ký đã được đưa vào chỉ mục. Add chỉ ghi thêm một dòng nhật ký; chỉ mục được ghi
+// lại khi Open/Close. Khi mở chỉ đọc phần nhật ký mới hơn chỉ mục (hoặc quét lại toàn bộ nếu chỉ mục
+// mất/hỏng, hay chương trình thoát trước Close), không bao giờ sort lại cả lịch sử.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <unordered_map>
+#include <cstdint>
+
+struct HighScoreEntry {
+    std::string playerName;
+    int score;
+    int level;
+    std::string date;
+
+    HighScoreEntry(std::string name = "", int sc = 0, int lv = 1, std::string dt = "")
+        : playerName(name), score(sc), level(lv), date(dt) {
+    }
+};
+
+const int HIGHSCORE_TOP_K = 64;
+
+class HighScoreStore {
+public:
+    // Mở nhật ký và chỉ mục (indexPath rỗng = logPath + ".idx"), đồng bộ chỉ mục nếu cần
+    bool Open(const std::string& logPath, const std::string& indexPath = "");
+    // Ghi lại chỉ mục nếu có dòng mới từ lần ghi trước, rồi đóng nhật ký
+    void Close();
+    ~HighScoreStore() { Close(); }
+
+    // Ghi thêm một dòng vào nhật ký và cập nhật top-K / điểm từng người trong bộ nhớ: O(K),
+    // không đọc lại file, không ghi chỉ mục
+    bool Add(const HighScoreEntry& entry);
+
+    // Tối đa n kết quả (n <= HIGHSCORE_TOP_K), điểm giảm dần, bằng điểm thì ai đạt trước đứng trước
+    std::vector<HighScoreEntry> Top(int n) const;
+    // Điểm cao nhất của một người chơi; false nếu chưa có
+    bool PlayerBest(const std::string& name, HighScoreEntry& best) const;
+    size_t PlayerCount() const { return best.size(); }
+
+private:
+    std::string logPath, indexPath;
+    std::ofstream log;                                     // Giữ mở để append, không mở lại mỗi ván
+    uint64_t logBytes = 0;                                 // Số byte nhật ký đã nằm trong chỉ mục
+    uint64_t savedBytes = 0;                               // logBytes của chỉ mục đang nằm trên đĩa
+    std::vector<HighScoreEntry> top;                       // Sắp xếp giảm dần, tối đa HIGHSCORE_TOP_K
+    std::unordered_map<std::string, HighScoreEntry> best;  // Tên -> lần chơi điểm cao nhất
+
+    void Insert(const HighScoreEntry& entry);
+    void CatchUp(uint64_t fileSize);
+    bool LoadIndex();
+    void SaveIndex();
+};
+
+// Tách một dòng "tên|điểm|level|ngày"; false nếu sai định dạng (không ném ngoại lệ như stoi)
+bool ParseHighScoreLine(const std::string& line, HighScoreEntry& entry);
@@ -0,0 +1,77 @@
+// InputThread.cpp — Cài đặt luồng đọc bàn phím
+
+#include "InputThread.h"
+#include "Terminal.h"
+
+using namespace std;
+
+// Khoảng chờ tối đa mỗi lần hỏi bàn phím: quyết định độ trễ của Stop()/Pause(), không phải của phím bấm
+static const int POLL_MS = 10;
+
+void InputThread::Start() {
+    if (running) return;
+    InputEvent ev;
+    while (queue.pop(ev)) {} // Bỏ phím còn sót từ lần trước
+    paused = false;
+    idle = false;
+    running = true;
+    worker = thread(&InputThread::Run, this);
+}
+
+void InputThread::Stop() {
+    if (!running) return;
+    running = false;
+    worker.join();
+}
+
+void InputThread::Pause() {
+    paused = true;
+    while (running && !idle) this_thread::sleep_for(chrono::milliseconds(1));
+}
+
+void InputThread::Resume() {
+    paused = false;
+}
+
+bool InputThread::WaitForEvent(double timeoutMs) {
+    unique_lock<mutex> lock(wakeMutex);
+    auto ready = [this] { return !queue.empty(); };
+    if (timeoutMs < 0) {
+        wake.wait(lock, ready);
+        return true;
+    }
+    if (timeoutMs <= 0) return ready();
+    return wake.wait_for(lock, chrono::duration<double, milli>(timeoutMs), ready);
+}
+
+void InputThread::Run() {
+    while (running) {
+        if (paused) {
+            idle = true;
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
+        }
+        idle = false;
+
+        int key;
+        if (!PollKey(POLL_MS, key)) {
+            if (InputClosed()) break; // stdin đóng: PollKey không còn chờ, vòng lặp sẽ quay không nghỉ
+            continue;
+        }
+
+        InputEvent ev{ key, false, chrono::steady_clock::now() };
+        if (key == KEY_EXTENDED || key == 0) {
+            // Mã thứ hai của phím mở rộng đến ngay sau tiền tố
+            if (!PollKey(POLL_MS, key)) continue;
+            ev.key = key;
+            ev.extended = true;
+        }
+        // Hàng đầy (64 phím chưa xử lý) thì bỏ phím mới: người chơi đang giữ phím
+        if (!queue.push(ev)) continue;
+
+        // Khóa rỗng để không lỡ lần đánh thức khi luồng chính vừa kiểm tra hàng đợi xong
+        { lock_guard<mutex> lock(wakeMutex); }
+        wake.notify_one();
+    }
+    idle = true;
+}
@@ -0,0 +1,46 @@
+// InputThread.h — Luồng riêng đọc bàn phím cho bản console
+// Mỗi phím được gắn thời điểm bấm và đẩy vào hàng đợi SPSC không khóa; vòng lặp game
+// lấy ra ở tick kế tiếp nên không phím nào bị bỏ, kể cả khi bấm nhiều phím trong một tick
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "SpscQueue.h"
+
+struct InputEvent {
+    int key;          // Mã phím như GetKey(); với phím mở rộng là mã thứ hai (KEY_UP, ...)
+    bool extended;    // Phím mũi tên/phím chức năng (tiền tố 224 hoặc 0)
+    std::chrono::steady_clock::time_point time;
+};
+
+class InputThread {
+public:
+    ~InputThread() { Stop(); }
+
+    void Start();
+    void Stop();
+
+    // Tạm dừng đọc phím để luồng chính dùng ReadLine/GetKey (nhập tên file, ...); chờ tới khi luồng nhập đã nhả stdin
+    void Pause();
+    void Resume();
+
+    // Luồng chính: lấy sự kiện kế tiếp
+    bool Pop(InputEvent& ev) { return queue.pop(ev); }
+    // Luồng chính: ngủ tới khi có sự kiện hoặc hết timeoutMs (timeoutMs < 0: chờ mãi)
+    bool WaitForEvent(double timeoutMs);
+
+private:
+    SpscQueue<InputEvent, 64> queue;
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> paused{ false };
+    std::atomic<bool> idle{ false };  // Luồng nhập đang không đọc stdin
+    std::mutex wakeMutex;             // Chỉ dùng để đánh thức luồng chính, không bảo vệ hàng đợi
+    std::condition_variable wake;
+
+    void Run();
+};
@@ -0,0 +1,282 @@
+// MapPack.cpp — Đọc/ghi file .map và gói màn chơi nhị phân
+
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include "MapPack.h"
+#include "ByteIO.h"
+
+using namespace std;
+
+static const uint8_t MAP_PACK_MAGIC[4] = { 'S', 'N', 'K', 'P' };
+static const size_t MAX_MAP_PACK_LEVELS = 1 << 16;
+
+// ===== TEXT =====
+bool ParseMapText(const string& text, MapData& map, string& error) {
+    MapData next;
+    next.startPos = { 0, 0 };
+    next.backgroundColor = 7;
+    vector<string> rows;
+    bool inGrid = false;
+    int lineNo = 0;
+    istringstream in(text);
+    string line;
+    while (getline(in, line)) {
+        lineNo++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (inGrid) {
+            if (line.empty()) continue;
+            if (!rows.empty() && line.size() != rows[0].size()) {
+                error = "line " + to_string(lineNo) + ": grid rows differ in length";
+                return false;
+            }
+            rows.push_back(line);
+            continue;
+        }
+        if (line.empty() || line[0] == '#') continue;
+        istringstream words(line);
+        string key;
+        words >> key;
+        if (key == "name") {
+            getline(words >> ws, next.themeName);
+        }
+        else if (key == "color") {
+            if (!(words >> next.backgroundColor)) { error = "line " + to_string(lineNo) + ": bad color"; return false; }
+        }
+        else if (key == "start") {
+            if (!(words >> next.startPos.x >> next.startPos.y)) { error = "line " + to_string(lineNo) + ": bad start"; return false; }
+        }
+        else if (key == "grid") {
+            inGrid = true;
+        }
+        else {
+            error = "line " + to_string(lineNo) + ": unknown key '" + key + "'";
+            return false;
+        }
+    }
+    if (rows.empty()) {
+        error = "missing grid";
+        return false;
+    }
+    if (rows[0].size() + 1 > (size_t)MAX_BOARD_SIZE || rows.size() + 1 > (size_t)MAX_BOARD_SIZE) {
+        error = "grid larger than " + to_string(MAX_BOARD_SIZE);
+        return false;
+    }
+
+    next.width = (int)rows[0].size() + 1;
+    next.height = (int)rows.size() + 1;
+    InitMapTiles(next);
+    for (int y = 1; y < next.height; y++) {
+        for (int x = 1; x < next.width; x++) {
+            char c = rows[y - 1][x - 1];
+            if (c == '#') SetTile(next, x, y, TILE_WALL);
+            else if (c == 'S') next.spawns.push_back({ x, y });
+            else if (c != '.') {
+                error = "grid row " + to_string(y) + ": unknown cell '" + string(1, c) + "'";
+                return false;
+            }
+        }
+    }
+    map = std::move(next);
+    return true;
+}
+
+string FormatMapText(const MapData& map) {
+    string s = "name " + map.themeName + "\n";
+    s += "color " + to_string(map.backgroundColor) + "\n";
+    s += "start " + to_string(map.startPos.x) + " " + to_string(map.startPos.y) + "\n";
+    s += "grid\n";
+    for (int y = 1; y < map.height; y++) {
+        for (int x = 1; x < map.width; x++) {
+            bool spawn = find(map.spawns.begin(), map.spawns.end(), Point{ x, y }) != map.spawns.end();
+            s += spawn ? 'S' : IsBlocked(map, { x, y }) ? '#' : '.';
+        }
+        s += '\n';
+    }
+    return s;
+}
+
+// ===== PACK =====
+static bool FitsPack(const MapData& map) {
+    auto fits = [](int v) { return v >= 0 && v <= 0xffff; };
+    if (map.width < 2 || map.height < 2 || map.width > MAX_BOARD_SIZE || map.height > MAX_BOARD_SIZE) return false;
+    if (!fits(map.startPos.x) || !fits(map.startPos.y) || map.spawns.size() > 0xffff) return false;
+    for (const Point& p : map.spawns)
+        if (p.x < 1 || p.x >= map.width || p.y < 1 || p.y >= map.height) return false;
+    return true;
+}
+
+bool EncodeMapPack(const vector<MapData>& maps, vector<uint8_t>& out) {
+    if (maps.empty() || maps.size() > MAX_MAP_PACK_LEVELS) return false;
+    for (const MapData& map : maps) if (!FitsPack(map)) return false;
+
+    out.clear();
+    ByteWriter w{ out };
+    for (uint8_t c : MAP_PACK_MAGIC) w.U8(c);
+    w.U16(MAP_PACK_VERSION);
+    w.U16((uint32_t)MAP_PACK_HEADER_SIZE);
+    w.U32(0);
+    w.U32(0);
+
+    // Chỉ mục điền sau khi biết vị trí từng màn
+    w.U32((uint32_t)maps.size());
+    size_t index = out.size();
+    out.resize(index + maps.size() * 8);
+    for (size_t i = 0; i < maps.size(); i++) {
+        const MapData& map = maps[i];
+        size_t begin = out.size();
+        w.U16((uint32_t)map.width);
+        w.U16((uint32_t)map.height);
+        w.U16((uint32_t)map.startPos.x);
+        w.U16((uint32_t)map.startPos.y);
+        w.U8((uint32_t)map.backgroundColor);
+        w.Str(map.themeName);
+        w.U16((uint32_t)map.spawns.size());
+        for (const Point& p : map.spawns) { w.U16((uint32_t)p.x); w.U16((uint32_t)p.y); }
+
+        int inner = map.width - 1;
+        size_t cells = (size_t)inner * (map.height - 1);
+        size_t bits = out.size();
+        out.resize(bits + (cells + 7) / 8, 0);
+        for (size_t k = 0; k < cells; k++)
+            if (IsBlocked(map, { 1 + (int)(k % inner), 1 + (int)(k / inner) })) out[bits + k / 8] |= (uint8_t)(1 << (k % 8));
+
+        // Chu trình Hamilton: ô đầu + 2 bit hướng (DIR_*) cho mỗi bước tiếp theo
+        size_t steps = map.cycleCells.size();
+        w.U32((uint32_t)steps);
+        if (steps > 0) {
+            w.U32((uint32_t)map.cycleCells[0]);
+            size_t dirs = out.size();
+            out.resize(dirs + (steps - 1 + 3) / 4, 0);
+            for (size_t k = 1; k < steps; k++) {
+                int from = map.cycleCells[k - 1], to = map.cycleCells[k];
+                int d = to == from - 1 ? DIR_LEFT : to == from + 1 ? DIR_RIGHT : to < from ? DIR_UP : DIR_DOWN;
+                out[dirs + (k - 1) / 4] |= (uint8_t)(d << (2 * ((k - 1) % 4)));
+            }
+        }
+
+        w.Put32(index + i * 8, (uint32_t)(begin - MAP_PACK_HEADER_SIZE));
+        w.Put32(index + i * 8 + 4, (uint32_t)(out.size() - begin));
+    }
+
+    size_t payloadSize = out.size() - MAP_PACK_HEADER_SIZE;
+    w.Put32(8, (uint32_t)payloadSize);
+    w.Put32(12, Fnv1a(out.data() + MAP_PACK_HEADER_SIZE, payloadSize));
+    return true;
+}
+
+bool MapPack::Open(const string& path) {
+    count = 0;
+    if (!file.Open(path)) return false;
+    return Open(file.data, file.size);
+}
+
+bool MapPack::Open(const uint8_t* data, size_t size) {
+    count = 0;
+    if (size < MAP_PACK_HEADER_SIZE || !equal(MAP_PACK_MAGIC, MAP_PACK_MAGIC + 4, data)) return false;
+
+    ByteReader h{ data + 4, data + MAP_PACK_HEADER_SIZE };
+    uint32_t version = h.U16();
+    uint32_t headerSize = h.U16();
+    uint32_t size32 = h.U32();
+    uint32_t checksum = h.U32();
+    if (version != MAP_PACK_VERSION || headerSize < MAP_PACK_HEADER_SIZE || headerSize > size) return false;
+    if (size32 != size - headerSize) return false;
+    if (Fnv1a(data + headerSize, size32) != checksum) return false;
+
+    ByteReader r{ data + headerSize, data + size };
+    uint32_t n = r.U32();
+    if (!r.ok || n == 0 || n > MAX_MAP_PACK_LEVELS || r.Left() < (size_t)n * 8) return false;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t offset = r.U32();
+        uint64_t length = r.U32();
+        if (offset + length > size32) return false;
+    }
+    payload = data + headerSize;
+    payloadSize = size32;
+    count = n;
+    return true;
+}
+
+// Đi lại chu trình đã lưu; mỗi bước phải tới ô trống chưa đi, bước cuối quay về ô đầu.
+// Kiểm tra số bước với số ô trống và số byte còn lại trước khi cấp phát theo diện tích bàn
+static bool ReadCycle(ByteReader& r, MapData& map, uint32_t steps, size_t freeCells) {
+    static const int DX[4] = { -1, 1, 0, 0 }, DY[4] = { 0, 0, -1, 1 };
+    int w = map.width;
+    // Như BuildHamiltonCycle: chu trình qua đúng mọi ô trống, chỉ có trên bàn dày
+    if (steps != freeCells || (size_t)w * map.height > (size_t)DENSE_BOARD_CELLS) return false;
+    int cell = (int)r.U32();
+    if (!r.ok || r.Left() < (steps - 1 + 3) / 4) return false;
+    map.cycleOrder.assign((size_t)w * map.height, -1);
+    map.cycleCells.resize(steps);
+    for (uint32_t k = 0; k < steps; k++) {
+        int x = cell % w, y = cell / w;
+        if (x < 1 || y < 1 || y >= map.height || IsBlocked(map, { x, y }) || map.cycleOrder[cell] >= 0) return false;
+        map.cycleCells[k] = cell;
+        map.cycleOrder[cell] = (int)k;
+        if (k + 1 < steps) {
+            int d = (r.p[k / 4] >> (2 * (k % 4))) & 3;
+            cell = (y + DY[d]) * w + x + DX[d];
+        }
+    }
+    r.p += (steps - 1 + 3) / 4;
+    int first = map.cycleCells[0], last = map.cycleCells[steps - 1];
+    return abs(first % w - last % w) + abs(first / w - last / w) == 1;
+}
+
+bool MapPack::Load(size_t i, MapData& map) const {
+    if (i >= count) return false;
+    ByteReader index{ payload + 4 + i * 8, payload + 4 + i * 8 + 8 };
+    uint32_t offset = index.U32();
+    uint32_t length = index.U32();
+
+    MapData next;
+    ByteReader r{ payload + offset, payload + offset + length };
+    next.width = (int)r.U16();
+    next.height = (int)r.U16();
+    next.startPos.x = (int)r.U16();
+    next.startPos.y = (int)r.U16();
+    next.backgroundColor = (int)r.U8();
+    next.themeName = r.Str();
+    uint32_t spawnCount = r.U16();
+    if (!r.ok || next.width < 2 || next.height < 2 || r.Left() < (size_t)spawnCount * 4) return false;
+    next.spawns.resize(spawnCount);
+    for (Point& p : next.spawns) {
+        p.x = (int)r.U16();
+        p.y = (int)r.U16();
+        if (p.x < 1 || p.x >= next.width || p.y < 1 || p.y >= next.height) return false;
+    }
+
+    int inner = next.width - 1;
+    size_t cells = (size_t)inner * (next.height - 1);
+    size_t bitmapBytes = (cells + 7) / 8;
+    if (r.Left() < bitmapBytes) return false;
+    InitMapTiles(next);
+    // Bitmap thưa: bỏ qua cả byte 0 (8 ô trống liền nhau)
+    size_t wallCells = 0;
+    for (size_t b = 0; b < bitmapBytes; b++) {
+        if (!r.p[b]) continue;
+        for (size_t k = b * 8; k < b * 8 + 8 && k < cells; k++)
+            if ((r.p[b] >> (k % 8)) & 1) {
+                next.tiles.Set(1 + (int)(k % inner), 1 + (int)(k / inner), TILE_WALL);
+                wallCells++;
+            }
+    }
+    r.p += bitmapBytes;
+
+    uint32_t steps = r.U32();
+    if (!r.ok) return false;
+    if (steps > 0 && !ReadCycle(r, next, steps, cells - wallCells)) return false;
+    if (r.Left() != 0) return false;
+    map = std::move(next);
+    return true;
+}
+
+bool MapPack::LoadAll(vector<MapData>& maps) const {
+    vector<MapData> next(count);
+    for (size_t i = 0; i < count; i++) {
+        if (!Load(i, next[i])) return false;
+    }
+    maps = std::move(next);
+    return true;
+}
@@ -0,0 +1,61 @@
+// MapPack.h — Bộ màn chơi đọc từ file: soạn bằng text (maps/*.map), dịch một lần thành gói nhị phân
+// (tools/MapPackCompiler), lúc chạy chỉ ánh xạ gói vào bộ nhớ (MappedFile) và chép bitmap tường ra tiles
+//
+// File .map (text, mỗi dòng một khóa, '#' đầu dòng là chú thích):
+//   name Peaceful Garden        tên theme
+//   color 2                     màu nền (mã màu console)
+//   start 35 10                 startPos
+//   grid                        các dòng sau là vùng chơi, không gồm viền (viền tự thêm)
+//   ....#####....               '.' trống, '#' tường, 'S' ô đuôi rắn lúc xuất phát (trống)
+//   Mọi dòng của grid dài bằng nhau: width = số cột + 1, height = số dòng + 1
+//
+// Gói (little-endian, không padding):
+//   Header 16 byte: "SNKP" | u16 version | u16 headerSize | u32 payloadSize | u32 FNV-1a(payload)
+//   Payload: u32 số màn | chỉ mục (u32 offset tính từ đầu payload, u32 size) mỗi màn | các màn
+//   Màn: u16 width | u16 height | u16 startX | u16 startY | u8 color | tên (Str) |
+//        u16 số điểm xuất phát | (u16 x, u16 y)... | bitmap tường vùng chơi
+//        (bit k = ô (1 + k % (width - 1), 1 + k / (width - 1)), bit thấp trước) |
+//        u32 độ dài chu trình Hamilton (0: không có) | u32 ô đầu | 2 bit hướng mỗi bước, 4 bước/byte
+//   Chu trình tính sẵn lúc dịch, nên nạp một màn chỉ là chép bitmap và đi lại chu trình, không tìm kiếm
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "SnakeSim.h"
+#include "MappedFile.h"
+
+const uint16_t MAP_PACK_VERSION = 1;
+const size_t MAP_PACK_HEADER_SIZE = 16;
+const char* const LEVEL_PACK_FILE = "levels.pack";  // Gói mặc định trong thư mục làm việc (như highscores.txt)
+
+// ===== TEXT =====
+// Đọc một file .map; false kèm thông báo lỗi (số dòng) nếu sai định dạng
+bool ParseMapText(const std::string& text, MapData& map, std::string& error);
+// Ghi map ra định dạng .map (dùng để xuất bộ map dựng sẵn)
+std::string FormatMapText(const MapData& map);
+
+// ===== PACK =====
+bool EncodeMapPack(const std::vector<MapData>& maps, std::vector<uint8_t>& out);
+
+// Gói đã ánh xạ: Open chỉ kiểm tra header, checksum và chỉ mục; Load dựng từng màn khi cần
+class MapPack {
+public:
+    bool Open(const std::string& path);
+    // Kiểm tra trên vùng nhớ có sẵn (data phải sống lâu hơn MapPack)
+    bool Open(const uint8_t* data, size_t size);
+
+    size_t Size() const { return count; }
+    // Dựng màn i (tiles, điểm xuất phát, chu trình Hamilton đã lưu)
+    bool Load(size_t i, MapData& map) const;
+    // Mọi màn theo thứ tự trong gói; maps giữ nguyên nếu có màn hỏng
+    bool LoadAll(std::vector<MapData>& maps) const;
+
+private:
+    MappedFile file;
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
+    size_t count = 0;
+};
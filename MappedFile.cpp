@@ -0,0 +1,81 @@
+// MappedFile.cpp — Cài đặt MappedFile cho Win32 và POSIX
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+
+#define NOMINMAX
+#include <windows.h>
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER len;
+    if (!GetFileSizeEx(file, &len) || len.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mapHandle = mapping;
+    data = (const uint8_t*)view;
+    size = (size_t)len.QuadPart;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) UnmapViewOfFile(data);
+    if (mapHandle) CloseHandle(mapHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    data = nullptr;
+    size = 0;
+    mapHandle = nullptr;
+    fileHandle = nullptr;
+}
+
+#else
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+bool MappedFile::Open(const std::string& path) {
+    Close();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // Vùng ánh xạ vẫn hợp lệ sau khi đóng fd
+    if (view == MAP_FAILED) return false;
+
+    data = (const uint8_t*)view;
+    size = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::Close() {
+    if (data) munmap((void*)data, size);
+    data = nullptr;
+    size = 0;
+}
+
+#endif
@@ -0,0 +1,28 @@
+// MappedFile.h — Ánh xạ cả file vào bộ nhớ chỉ đọc (mmap / CreateFileMapping)
+// Đọc trực tiếp từ trang của hệ điều hành, không sao chép qua iostream
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+struct MappedFile {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { Close(); }
+
+    // Trả về false nếu không mở được hoặc file rỗng
+    bool Open(const std::string& path);
+    void Close();
+
+private:
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mapHandle = nullptr;
+#endif
+};
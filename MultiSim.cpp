@@ -0,0 +1,208 @@
+// MultiSim.cpp — Cài đặt bộ chạy nhiều ván cùng nhịp
+
+#include "MultiSim.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MULTISIM_HAS_PREFETCH 1
+#endif
+
+using namespace std;
+
+const int NO_TARGET = -1000;  // Tọa độ mồi/cổng khi không có: không bao giờ trùng ô kề đầu rắn
+// Khoảng cách nạp trước: đối tượng SnakeSim trước, rồi tới các mảng nó trỏ tới
+const size_t PREFETCH_OBJECT = 16;
+const size_t PREFETCH_STATE = 8;
+// Ít ván hơn thì toàn bộ trạng thái đã nằm trong cache, nạp trước chỉ tốn thêm lệnh
+const size_t PREFETCH_MIN_GAMES = 2048;
+
+static inline void Prefetch(const void* p) {
+#ifdef MULTISIM_HAS_PREFETCH
+    _mm_prefetch((const char*)p, _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+bool MultiSim::Reset(const vector<uint64_t>& seeds, int mode, bool keepLength, const vector<MapData>* levels) {
+    const vector<MapData>& maps = levels ? *levels : DefaultLevelMaps();
+    // Chỉ số ô và từ bitboard là int32: chỉ nhận bàn dày như tập ô trống của SnakeSim
+    int maxW = 0, maxH = 0;
+    for (const MapData& map : maps) {
+        if ((size_t)map.width * map.height > (size_t)DENSE_BOARD_CELLS) return false;
+        maxW = max(maxW, map.width);
+        maxH = max(maxH, map.height);
+    }
+    size_t words = ((size_t)(maxW + 1) * (maxH + 1) + 31) / 32;
+    if (seeds.size() * words > (size_t)INT32_MAX) return false;
+    levelSet = &maps;
+
+    // Bitmap tường của từng map, dùng chung cho mọi ván
+    walls.clear();
+    mapWallBase.clear();
+    for (const MapData& map : *levelSet) {
+        mapWallBase.push_back((int32_t)walls.size());
+        size_t cells = (size_t)map.Stride() * (map.height + 1);
+        walls.resize(walls.size() + (cells + 31) / 32, 0);
+        uint32_t* bits = walls.data() + mapWallBase.back();
+        for (int y = 0; y <= map.height; y++)
+            for (int x = 0; x <= map.width; x++) {
+                size_t i = (size_t)map.Index(x, y);
+                if (map.tiles.Get(x, y) != TILE_EMPTY) bits[i >> 5] |= 1u << (i & 31);
+            }
+    }
+
+    // Ô kề đầu rắn có thể nằm trên viền (y = height): chừa đủ (width + 1) x (height + 1) bit
+    // để không đọc sang bitboard của ván bên cạnh
+    occWords = words;
+
+    size_t count = seeds.size();
+    games.resize(count);
+    for (vector<int32_t>* field : { &headX, &headY, &dir, &active, &offBoard, &foodX, &foodY, &gateX, &gateY,
+                                    &wallBase, &stride, &gridW, &occBase, &nextX, &nextY, &flags })
+        field->assign(count, 0);
+    occ.assign(count * occWords, 0);
+
+    aliveCount = 0;
+    for (size_t g = 0; g < count; g++) {
+        SnakeSim& s = games[g];
+        s.levels = levels;
+        s.mode = mode;
+        s.keepLengthWhenLevelUp = keepLength;
+        s.Reset(seeds[g]);
+        occBase[g] = (int32_t)(g * occWords);
+        SyncLane(g);
+        if (s.alive) aliveCount++;
+    }
+    return true;
+}
+
+// Chép trạng thái nóng của ván g từ SnakeSim sang các mảng (sau Reset, qua màn, chết)
+void MultiSim::SyncLane(size_t g) {
+    const SnakeSim& s = games[g];
+    active[g] = s.alive ? -1 : 0;
+    offBoard[g] = s.headOffBoard ? -1 : 0;
+    if (!s.snake.empty()) {
+        headX[g] = s.snake.back().x;
+        headY[g] = s.snake.back().y;
+    }
+
+    bool food = s.foodVisible && s.foodIndex >= 0 && s.foodIndex < (int)s.foods.size();
+    foodX[g] = food ? s.foods[s.foodIndex].x : NO_TARGET;
+    foodY[g] = food ? s.foods[s.foodIndex].y : NO_TARGET;
+    gateX[g] = s.gateActive ? s.gatePos.x : NO_TARGET;
+    gateY[g] = s.gateActive ? s.gatePos.y : NO_TARGET;
+
+    size_t mapIndex = s.activeMap - levelSet->data();
+    wallBase[g] = mapWallBase[mapIndex];
+    stride[g] = s.activeMap->Stride();
+    gridW[g] = s.gridWidth;
+
+    // Bit y * gridWidth + x cho mỗi đoạn thân trong map, giống SnakeSim::IsOccupied
+    uint32_t* dst = occ.data() + occBase[g];
+    memset(dst, 0, occWords * sizeof(uint32_t));
+    for (const Point& p : s.snake) {
+        if (p.x < 0 || p.x >= s.gridWidth || p.y < 0 || p.y >= s.gridHeight) continue;
+        size_t i = (size_t)p.y * s.gridWidth + p.x;
+        if (i >> 5 < occWords) dst[i >> 5] |= 1u << (i & 31);
+    }
+}
+
+// Những chỗ Advance đọc/ghi: ô mới và ô đuôi trong RingBuffer, bitboard và tập ô trống
+void MultiSim::PrefetchState(size_t g) {
+    const SnakeSim& s = games[g];
+    if (s.snake.empty()) return;
+    const Point& tail = s.snake.front();
+    Prefetch(&tail);
+    Prefetch(&s.snake.back() + 1);
+    auto inside = [&](int x, int y) { return x >= 0 && x < s.gridWidth && y >= 0 && y < s.gridHeight; };
+    if (!inside(nextX[g], nextY[g]) || !inside(tail.x, tail.y)) return;
+    Prefetch(s.occupancy.Row(nextX[g], nextY[g]));
+    Prefetch(s.occupancy.Row(tail.x, tail.y));
+    if (!s.denseFree) return;
+    Prefetch(&s.freeCells.pos[nextY[g] * s.gridWidth + nextX[g]]);
+    Prefetch(&s.freeCells.pos[tail.y * s.gridWidth + tail.x]);
+    Prefetch(s.freeCells.cells.data() + s.freeCells.cells.size());
+}
+
+size_t MultiSim::Step(const int* dirs) {
+    size_t count = games.size();
+    copy(dirs, dirs + count, dir.begin());
+
+    CheckCollisions();
+
+    // Áp kết quả: phần luật còn lại chạy trên SnakeSim của từng ván. Ô đầu mới của mọi ván đã biết
+    // trước, nên nạp sẵn vào cache dữ liệu mà Advance sẽ chạm tới ở các ván phía trước
+    bool prefetch = count >= PREFETCH_MIN_GAMES;
+    for (size_t g = 0; g < count; g++) {
+        if (prefetch && g + PREFETCH_OBJECT < count) Prefetch(&games[g + PREFETCH_OBJECT]);
+        if (prefetch && g + PREFETCH_STATE < count && active[g + PREFETCH_STATE]) PrefetchState(g + PREFETCH_STATE);
+        if (!active[g]) continue;
+        SnakeSim& s = games[g];
+        s.ticks++;
+        if (flags[g] & FLAG_DEAD) {
+            s.alive = false;
+            active[g] = 0;
+            aliveCount--;
+            continue;
+        }
+
+        Point nh{ nextX[g], nextY[g] };
+        Point tail = s.snake.front();
+        bool eat = (flags[g] & FLAG_EAT) != 0;
+        int events = s.Advance(nh, dir[g], eat, (flags[g] & FLAG_GATE) != 0);
+
+        if ((events & EVT_LEVEL_UP) || !s.alive) {
+            // Map, thân rắn, mồi đều đổi: chép lại toàn bộ
+            SyncLane(g);
+            if (!s.alive) aliveCount--;
+            continue;
+        }
+
+        uint32_t* bits = occ.data() + occBase[g];
+        int head = nh.y * gridW[g] + nh.x;
+        bits[head >> 5] |= 1u << (head & 31);
+        if (eat) {
+            bool food = s.foodVisible && s.foodIndex < (int)s.foods.size();
+            foodX[g] = food ? s.foods[s.foodIndex].x : NO_TARGET;
+            foodY[g] = food ? s.foods[s.foodIndex].y : NO_TARGET;
+            gateX[g] = s.gateActive ? s.gatePos.x : NO_TARGET;
+            gateY[g] = s.gateActive ? s.gatePos.y : NO_TARGET;
+        }
+        else {
+            int t = tail.y * gridW[g] + tail.x;
+            bits[t >> 5] &= ~(1u << (t & 31));
+        }
+        headX[g] = nh.x;
+        headY[g] = nh.y;
+    }
+    return aliveCount;
+}
+
+// ===== KIỂM TRA VA CHẠM =====
+// Cùng điều kiện với SnakeSim::Step: đầu ngoài map, đâm tường hoặc đâm thân rắn (kể cả đuôi)
+
+void MultiSim::CheckCollisions() {
+    for (size_t g = 0; g < games.size(); g++) {
+        if (!active[g]) continue;
+        int d = dir[g];
+        int nx = headX[g] + (d == DIR_RIGHT) - (d == DIR_LEFT);
+        int ny = headY[g] + (d == DIR_DOWN) - (d == DIR_UP);
+        nextX[g] = nx;
+        nextY[g] = ny;
+
+        if (offBoard[g]) { flags[g] = FLAG_DEAD; continue; }
+        int w = ny * stride[g] + nx;
+        int o = ny * gridW[g] + nx;
+        bool wall = (walls[wallBase[g] + (w >> 5)] >> (w & 31)) & 1;
+        bool body = (occ[occBase[g] + (o >> 5)] >> (o & 31)) & 1;
+        if (wall || body) { flags[g] = FLAG_DEAD; continue; }
+
+        int f = 0;
+        if (nx == foodX[g] && ny == foodY[g]) f |= FLAG_EAT;
+        if (nx == gateX[g] && ny == gateY[g]) f |= FLAG_GATE;
+        flags[g] = f;
+    }
+}
@@ -0,0 +1,60 @@
+// MultiSim.h — Chạy nhiều ván cùng nhịp (lockstep), kiểm tra va chạm theo lô
+//
+// Trạng thái nóng của mỗi bước (đầu rắn, hướng, mồi đang nhắm, cổng, bitboard thân rắn)
+// được giữ dạng structure-of-arrays: mỗi trường là một mảng theo chỉ số ván, và một lượt tính
+// NextHead, đọc bit tường/thân rắn và so khớp mồi/cổng cho mọi ván. Ô đầu mới của mọi ván biết
+// trước lượt áp kết quả, nên dữ liệu SnakeSim::Advance sẽ chạm tới được nạp sẵn vào cache.
+// Phần còn lại của luật (ăn mồi, sinh mồi/cổng, qua màn) vẫn chạy qua SnakeSim::Advance của
+// từng ván, nên kết quả giống hệt từng bit với gọi SnakeSim::Step cho từng ván.
+// Advance chiếm gần hết thời gian một bước, nên kiểm tra bằng SIMD (đã thử SSE2/AVX2) không nhanh hơn.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "SnakeSim.h"
+
+class MultiSim {
+public:
+    // Trạng thái đầy đủ của từng ván, đọc được như SnakeSim thường (chính sách bot, thống kê)
+    std::vector<SnakeSim> games;
+
+    // Bắt đầu seeds.size() ván mới, ván i dùng seeds[i]; levels = nullptr: bộ map mặc định.
+    // Bitmap tường và bitboard thân rắn là mảng dày theo ô: false (không đổi gì) nếu có map quá
+    // DENSE_BOARD_CELLS ô, hoặc tổng bitboard của mọi ván vượt chỉ số 32 bit
+    bool Reset(const std::vector<uint64_t>& seeds, int mode = MODE_CLASSIC, bool keepLength = true,
+        const std::vector<MapData>* levels = nullptr);
+
+    // Một bước cho mọi ván còn sống, ván i đi theo dirs[i]; trả về số ván còn sống
+    size_t Step(const int* dirs);
+
+    size_t Size() const { return games.size(); }
+    size_t AliveCount() const { return aliveCount; }
+
+private:
+    // Cờ kết quả kiểm tra của mỗi ván
+    static const int FLAG_DEAD = 1;
+    static const int FLAG_EAT = 2;
+    static const int FLAG_GATE = 4;
+
+    size_t aliveCount = 0;
+    size_t occWords = 0;     // Số từ 32 bit bitboard thân rắn của mỗi ván
+
+    // Structure-of-arrays, mỗi mảng có games.size() phần tử
+    std::vector<int32_t> headX, headY, dir;
+    std::vector<int32_t> active;    // -1: ván còn sống, 0: đã chết
+    std::vector<int32_t> offBoard;  // -1: đầu nằm ngoài map (bước kế tiếp chắc chắn chết)
+    std::vector<int32_t> foodX, foodY, gateX, gateY;  // Mồi đang hiện và cổng, -1000 nếu không có
+    std::vector<int32_t> wallBase, stride;  // Bitmap tường của map hiện tại: từ bắt đầu, độ rộng hàng (width + 1)
+    std::vector<int32_t> gridW, occBase;    // Bitboard thân rắn: độ rộng hàng và từ bắt đầu của ván
+    std::vector<int32_t> nextX, nextY, flags;  // Kết quả kiểm tra
+
+    std::vector<uint32_t> walls;  // Bitmap tường của mọi map, bit y * (width + 1) + x, 1 = chặn
+    std::vector<int32_t> mapWallBase;
+    std::vector<uint32_t> occ;    // Bitboard thân rắn của mọi ván, bit y * gridWidth + x
+    const std::vector<MapData>* levelSet = nullptr;
+
+    void SyncLane(size_t g);
+    void PrefetchState(size_t g);
+    void CheckCollisions();
+};
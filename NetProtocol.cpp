@@ -0,0 +1,169 @@
+// NetProtocol.cpp — Mã hóa/giải mã khung tin, delta và keyframe
+
+#include "NetProtocol.h"
+#include "ByteIO.h"
+#include "SnakeSave.h"
+
+using namespace std;
+
+static Point StepFrom(const Point& p, int dir) {
+    if (dir == DIR_LEFT) return { p.x - 1, p.y };
+    if (dir == DIR_RIGHT) return { p.x + 1, p.y };
+    if (dir == DIR_UP) return { p.x, p.y - 1 };
+    return { p.x, p.y + 1 };
+}
+
+size_t BeginFrame(vector<uint8_t>& out, int type) {
+    size_t start = out.size();
+    ByteWriter w{ out };
+    w.U16(0);
+    w.U8((uint32_t)type);
+    return start;
+}
+
+bool EndFrame(vector<uint8_t>& out, size_t start) {
+    size_t payload = out.size() - start - NET_FRAME_HEADER;
+    if (payload > 0xffff) {
+        out.resize(start);
+        return false;
+    }
+    out[start] = (uint8_t)payload;
+    out[start + 1] = (uint8_t)(payload >> 8);
+    return true;
+}
+
+void AppendFrame(vector<uint8_t>& out, int type, const uint8_t* payload, size_t size) {
+    size_t start = BeginFrame(out, type);
+    out.insert(out.end(), payload, payload + size);
+    EndFrame(out, start);
+}
+
+bool NextFrame(const uint8_t* buf, size_t size, size_t& pos, int& type, const uint8_t*& payload, size_t& payloadSize) {
+    if (pos > size || size - pos < NET_FRAME_HEADER) return false;
+    size_t n = buf[pos] | ((size_t)buf[pos + 1] << 8);
+    if (size - pos - NET_FRAME_HEADER < n) return false;
+    type = buf[pos + 2];
+    payload = buf + pos + NET_FRAME_HEADER;
+    payloadSize = n;
+    pos += NET_FRAME_HEADER + n;
+    return true;
+}
+
+void CaptureDeltaBase(const SnakeSim& sim, DeltaBase& base) {
+    base.length = sim.snake.size();
+    base.head = sim.snake.empty() ? Point{ 0, 0 } : sim.snake.back();
+    base.foods = sim.foods;
+    base.gatePos = sim.gatePos;
+    base.gateActive = sim.gateActive;
+    base.speedLevel = sim.speedLevel;
+}
+
+bool EncodeDelta(const DeltaBase& base, const SnakeSim& sim, int events, vector<uint8_t>& out) {
+    if ((events & EVT_LEVEL_UP) || sim.speedLevel != base.speedLevel) return false;
+
+    int flags = 0;
+    if (!sim.alive) flags |= DELTA_DEAD;
+    else if (events & EVT_MOVED) {
+        bool grew = sim.snake.size() == base.length + 1;
+        if ((!grew && sim.snake.size() != base.length) || sim.snake.back() != StepFrom(base.head, sim.moving)) return false;
+        flags |= DELTA_MOVED | sim.moving | (grew ? DELTA_GREW : 0);
+    }
+    bool foodsChanged = sim.foods.size() != base.foods.size();
+    for (size_t i = 0; !foodsChanged && i < sim.foods.size(); i++) foodsChanged = sim.foods[i] != base.foods[i];
+    if (foodsChanged && sim.foods.size() > (size_t)FOOD_COUNT) return false;
+    if (foodsChanged) flags |= DELTA_FOODS;
+    if (sim.gateActive != base.gateActive || sim.gatePos != base.gatePos) flags |= DELTA_GATE;
+
+    size_t start = BeginFrame(out, NET_DELTA);
+    ByteWriter w{ out };
+    w.U32((uint32_t)sim.ticks);
+    w.U8((uint32_t)flags);
+    w.U32((uint32_t)sim.score);
+    w.U8((uint32_t)(sim.foodIndex & 0x7f) | (sim.foodVisible ? 0x80 : 0));
+    if (flags & DELTA_FOODS) {
+        w.U8((uint32_t)sim.foods.size());
+        for (const Point& f : sim.foods) {
+            w.U16((uint32_t)f.x);
+            w.U16((uint32_t)f.y);
+        }
+    }
+    if (flags & DELTA_GATE) {
+        w.U8(sim.gateActive ? 1 : 0);
+        w.U16(sim.gateActive ? (uint32_t)sim.gatePos.x : 0xffff);
+        w.U16(sim.gateActive ? (uint32_t)sim.gatePos.y : 0xffff);
+    }
+    return EndFrame(out, start);
+}
+
+bool EncodeKeyframe(const SnakeSim& sim, uint32_t levelHash, vector<uint8_t>& out) {
+    vector<uint8_t> snapshot;
+    if (!EncodeSnapshot(sim, snapshot)) return false;
+    size_t start = BeginFrame(out, NET_KEYFRAME);
+    ByteWriter{ out }.U32(levelHash);
+    out.insert(out.end(), snapshot.begin(), snapshot.end());
+    return EndFrame(out, start);
+}
+
+void AppendHello(vector<uint8_t>& out, int flags, uint32_t levelHash) {
+    vector<uint8_t> payload;
+    ByteWriter w{ payload };
+    w.U8(NET_VERSION);
+    w.U8((uint32_t)flags);
+    w.U32(levelHash);
+    AppendFrame(out, NET_HELLO, payload.data(), payload.size());
+}
+
+bool ApplyDelta(SnakeSim& mirror, const uint8_t* payload, size_t size, bool& dead) {
+    ByteReader r{ payload, payload + size };
+    uint32_t tick = r.U32();
+    int flags = (int)r.U8();
+    int score = (int)r.U32();
+    uint32_t food = r.U8();
+    vector<Point> foods;
+    if (flags & DELTA_FOODS) {
+        uint32_t count = r.U8();
+        if (count > (uint32_t)FOOD_COUNT) return false;
+        for (uint32_t i = 0; i < count; i++) {
+            int x = (int)r.U16();
+            int y = (int)r.U16();
+            foods.push_back({ x, y });
+        }
+    }
+    Point gate{ -1, -1 };
+    bool gateActive = false;
+    if (flags & DELTA_GATE) {
+        gateActive = r.U8() != 0;
+        int x = (int)r.U16();
+        int y = (int)r.U16();
+        if (gateActive) gate = { x, y };  // Cổng đóng: tọa độ bỏ qua, giữ { -1, -1 } như SnakeSim
+    }
+    if (!r.ok || tick != (uint32_t)(mirror.ticks + 1)) return false;
+    if ((flags & DELTA_MOVED) && mirror.snake.empty()) return false;
+
+    dead = (flags & DELTA_DEAD) != 0;
+    if (dead) mirror.alive = false;
+    if (flags & DELTA_MOVED) {
+        int dir = flags & 3;
+        mirror.snake.push_back(StepFrom(mirror.snake.back(), dir));
+        if (!(flags & DELTA_GREW)) mirror.snake.pop_front();
+        mirror.moving = dir;
+    }
+    mirror.ticks++;
+    mirror.score = score;
+    mirror.foodIndex = (int)(food & 0x7f);
+    mirror.foodVisible = (food & 0x80) != 0;
+    if (flags & DELTA_FOODS) mirror.foods = foods;
+    if (flags & DELTA_GATE) {
+        mirror.gateActive = gateActive;
+        mirror.gatePos = gate;
+    }
+    return true;
+}
+
+bool ApplyKeyframe(SnakeSim& mirror, const uint8_t* payload, size_t size, uint32_t levelHash) {
+    ByteReader r{ payload, payload + size };
+    if (r.U32() != levelHash || !r.ok) return false;
+    if (!DecodeSnapshot(mirror, payload + 4, size - 4)) return false;
+    mirror.alive = true;
+    return true;
+}
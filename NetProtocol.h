@@ -0,0 +1,78 @@
+// NetProtocol.h — Giao thức mạng giữa máy chủ chạy ván chơi (tools/SnakeServer) và máy khách
+//
+// Mỗi khung tin: u16 độ dài phần dữ liệu | u8 loại | dữ liệu (little-endian, ByteIO.h).
+// Máy chủ giữ ván thật (SnakeSim) và gửi:
+//   NET_KEYFRAME  mã bộ map (LevelSetHash) + snapshot đầy đủ (định dạng SnakeSave) khi vào ván, qua màn,
+//                 ván mới, định kỳ và khi máy khách xin đồng bộ lại
+//   NET_DELTA     thay đổi của một tick: hướng đầu mới, có bỏ đuôi không, điểm, mồi đang hiện và chỉ
+//                 khi thay đổi mới kèm danh sách mồi (tối đa FOOD_COUNT) và cổng. Kích thước không phụ
+//                 thuộc độ dài rắn (13 byte thường gặp, tối đa NET_DELTA_MAX)
+// Máy khách gửi NET_HELLO khi kết nối, NET_INPUT khi bấm hướng, NET_RESYNC khi lệch trạng thái.
+// HELLO mang mã bộ map của máy khách: khác phiên bản hoặc khác bộ map (levels.pack) thì máy chủ ngắt.
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "SnakeSim.h"
+
+const uint8_t NET_VERSION = 2;  // 2: thêm mã bộ map vào HELLO và keyframe
+const uint16_t NET_DEFAULT_PORT = 7878;
+const size_t NET_FRAME_HEADER = 3;
+
+// Loại khung tin
+const int NET_HELLO = 1;      // Khách -> chủ: u8 phiên bản, u8 cờ NET_HELLO_*, u32 mã bộ map
+const int NET_INPUT = 2;      // Khách -> chủ: u8 hướng (DIR_*)
+const int NET_RESYNC = 3;     // Khách -> chủ: xin keyframe ở tick kế tiếp
+const int NET_KEYFRAME = 16;  // Chủ -> khách: u32 mã bộ map, snapshot SnakeSave
+const int NET_DELTA = 17;     // Chủ -> khách: thay đổi của một tick
+
+const int NET_HELLO_AUTOPILOT = 1;  // Máy chủ tự lái rắn của phiên này (chạy thử tải)
+const size_t NET_HELLO_SIZE = 6;
+
+// Cờ trong NET_DELTA (2 bit thấp là hướng đầu mới)
+const int DELTA_MOVED = 4;    // Thêm đầu mới theo hướng
+const int DELTA_GREW = 8;     // Không bỏ đuôi (vừa ăn)
+const int DELTA_FOODS = 16;   // Kèm danh sách mồi mới
+const int DELTA_GATE = 32;    // Kèm trạng thái cổng
+const int DELTA_DEAD = 64;    // Rắn chết ở tick này, máy chủ sẽ gửi keyframe ván mới
+
+const size_t NET_DELTA_MAX = 10 + 1 + FOOD_COUNT * 4 + 5;
+
+// Mở một khung tin kiểu type ở cuối out, trả về vị trí để EndFrame ghi độ dài
+size_t BeginFrame(std::vector<uint8_t>& out, int type);
+// false nếu dữ liệu quá 65535 byte (khung bị bỏ khỏi out)
+bool EndFrame(std::vector<uint8_t>& out, size_t start);
+// Khung tin nhỏ của máy khách (HELLO, INPUT, RESYNC) ghi một lần
+void AppendFrame(std::vector<uint8_t>& out, int type, const uint8_t* payload, size_t size);
+
+// Tách khung tin kế tiếp trong buf từ vị trí pos; false nếu chưa đủ byte cho cả khung (hoặc pos > size)
+bool NextFrame(const uint8_t* buf, size_t size, size_t& pos, int& type, const uint8_t*& payload, size_t& payloadSize);
+
+// Trạng thái trước Step mà EncodeDelta cần để biết tick đã đổi những gì
+struct DeltaBase {
+    size_t length = 0;
+    Point head{ 0, 0 };
+    std::vector<Point> foods;
+    Point gatePos{ -1, -1 };
+    bool gateActive = false;
+    int speedLevel = 1;
+};
+
+void CaptureDeltaBase(const SnakeSim& sim, DeltaBase& base);
+
+// Ghi khung NET_DELTA cho tick vừa chạy (events = kết quả Step). false nếu thay đổi không diễn tả
+// được bằng delta (qua màn, đổi độ dài bất thường): khi đó gửi keyframe
+bool EncodeDelta(const DeltaBase& base, const SnakeSim& sim, int events, std::vector<uint8_t>& out);
+// levelHash: LevelSetHash của bộ map sim.levels
+bool EncodeKeyframe(const SnakeSim& sim, uint32_t levelHash, std::vector<uint8_t>& out);
+// Khung NET_HELLO của máy khách
+void AppendHello(std::vector<uint8_t>& out, int flags, uint32_t levelHash);
+
+// Áp delta lên bản sao của máy khách: chỉ cập nhật phần dùng để vẽ (thân, mồi, cổng, điểm, tick),
+// không dựng lại bitboard. false nếu delta hỏng hoặc không khớp tick (cần xin keyframe)
+bool ApplyDelta(SnakeSim& mirror, const uint8_t* payload, size_t size, bool& dead);
+// Thay bản sao bằng keyframe; mirror.levels phải là bộ map giống máy chủ: false nếu mã bộ map trong
+// keyframe khác levelHash
+bool ApplyKeyframe(SnakeSim& mirror, const uint8_t* payload, size_t size, uint32_t levelHash);
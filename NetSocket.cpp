@@ -0,0 +1,129 @@
+// NetSocket.cpp — Cài đặt socket POSIX; bản Windows chỉ trả về lỗi
+
+#include "NetSocket.h"
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+
+int NetListen(int port, int backlog) {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    bool v6 = fd >= 0;
+    if (!v6) fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int one = 1, zero = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    int bound;
+    if (v6) {
+        // Nhận cả IPv4 (địa chỉ ánh xạ ::ffff:a.b.c.d)
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+        sockaddr_in6 addr{};
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons((uint16_t)port);
+        bound = ::bind(fd, (sockaddr*)&addr, sizeof(addr));
+    }
+    else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((uint16_t)port);
+        bound = ::bind(fd, (sockaddr*)&addr, sizeof(addr));
+    }
+    if (bound != 0 || listen(fd, backlog) != 0 || !NetSetNonBlocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int NetConnect(const string& host, int port) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* list = nullptr;
+    if (getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &list) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo* a = list; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(list);
+    if (fd >= 0) NetSetNoDelay(fd);
+    return fd;
+}
+
+int NetAccept(int listenFd) {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0 && errno == EINTR) continue;
+        if (fd < 0) return -1;
+        if (!NetSetNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        NetSetNoDelay(fd);
+        return fd;
+    }
+}
+
+bool NetSetNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+void NetSetNoDelay(int fd) {
+    // Delta nhỏ gửi mỗi tick: không gom gói (Nagle) để không trễ thêm
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+void NetClose(int fd) {
+    if (fd >= 0) close(fd);
+}
+
+long NetSend(int fd, const void* data, size_t size) {
+    while (true) {
+        ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+        if (n >= 0) return (long)n;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+}
+
+long NetRecv(int fd, void* data, size_t size) {
+    while (true) {
+        ssize_t n = recv(fd, data, size, 0);
+        if (n > 0) return (long)n;
+        if (n == 0) return -1;
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+    }
+}
+
+#else
+
+int NetListen(int, int) { return -1; }
+int NetConnect(const std::string&, int) { return -1; }
+int NetAccept(int) { return -1; }
+bool NetSetNonBlocking(int) { return false; }
+void NetSetNoDelay(int) {}
+void NetClose(int) {}
+long NetSend(int, const void*, size_t) { return -1; }
+long NetRecv(int, void*, size_t) { return -1; }
+
+#endif
@@ -0,0 +1,22 @@
+// NetSocket.h — Vài hàm socket TCP tối thiểu cho máy chủ/máy khách mạng (POSIX)
+// Trên Windows các hàm trả về lỗi: chơi qua mạng chưa hỗ trợ ở bản Win32
+
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// Trả về fd, -1 nếu lỗi. NetListen mở cổng trên mọi địa chỉ (SO_REUSEADDR), không chặn
+int NetListen(int port, int backlog);
+// Kết nối (chặn tới khi xong), bật TCP_NODELAY; host là tên hoặc địa chỉ IPv4/IPv6
+int NetConnect(const std::string& host, int port);
+// Nhận một kết nối đang chờ (fd không chặn, TCP_NODELAY); -1 khi hết kết nối chờ
+int NetAccept(int listenFd);
+bool NetSetNonBlocking(int fd);
+void NetSetNoDelay(int fd);
+void NetClose(int fd);
+
+// Số byte đã gửi/nhận; 0 khi không gửi/nhận được lúc này (không chặn);
+// -1 khi kết nối đóng hoặc lỗi
+long NetSend(int fd, const void* data, size_t size);
+long NetRecv(int fd, void* data, size_t size);
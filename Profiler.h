@@ -0,0 +1,250 @@
+// Profiler.h — Đo thời gian từng pha của vòng lặp game và độ lệch nhịp tick
+//
+// Chỉ có khi build với -DSNAKE_PROFILE. Không định nghĩa thì mọi macro PROFILE_* là lệnh rỗng,
+// bản phát hành không tốn gì.
+//
+// Mỗi pha được đo bằng rdtsc (x86) hoặc steady_clock, rồi đổi ra micro giây khi in. Hệ số đổi được
+// hiệu chuẩn theo steady_clock trong suốt thời gian đo. Các pha lồng nhau được tính riêng: pha con
+// tạm dừng pha cha, nên tổng các pha đúng bằng thời gian của vòng lặp.
+
+#pragma once
+
+#ifdef SNAKE_PROFILE
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define SNAKE_PROFILE_RDTSC 1
+#endif
+
+const int PHASE_IDLE = 0;      // Chờ phím hoặc chờ tới tick
+const int PHASE_INPUT = 1;     // Xử lý phím, lệnh lưu/nạp
+const int PHASE_SIMULATE = 2;  // Chọn hướng (bot) và bước mô phỏng
+const int PHASE_EFFECTS = 3;   // Hiệu ứng qua màn, chết (kể cả thời gian ngủ)
+const int PHASE_RENDER = 4;    // Dựng khung hình, HUD
+const int PHASE_PRESENT = 5;   // Ghi ra console / window.display()
+const int PHASE_COUNT = 6;
+
+inline const char* PhaseName(int phase) {
+    static const char* names[PHASE_COUNT] = { "idle", "input", "simulate", "effects", "render", "present" };
+    return phase >= 0 && phase < PHASE_COUNT ? names[phase] : "?";
+}
+
+// Đồng hồ của profiler: chu kỳ CPU nếu có rdtsc, không thì nano giây của steady_clock
+inline uint64_t ProfileClock() {
+#ifdef SNAKE_PROFILE_RDTSC
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Histogram thang log: mỗi lũy thừa của 2 chia 4 ngăn (sai số dưới 25%), số ngăn cố định,
+// thêm một mẫu không cấp phát
+struct LogHistogram {
+    static const int BUCKETS = 256;
+    uint64_t counts[BUCKETS] = {};
+    uint64_t samples = 0;
+    uint64_t sum = 0;
+    uint64_t maxValue = 0;
+
+    static int Bucket(uint64_t v) {
+        if (v < 4) return (int)v;
+        int b = 0;
+        for (int s = 32; s > 0; s >>= 1)
+            if (v >> (b + s)) b += s;
+        return 4 * (b - 1) + (int)((v >> (b - 2)) & 3);
+    }
+
+    // Giá trị lớn nhất thuộc ngăn
+    static uint64_t BucketTop(int bucket) {
+        if (bucket < 4) return (uint64_t)bucket;
+        int b = bucket / 4 + 1;
+        uint64_t width = 1ull << (b - 2);
+        return (uint64_t)(4 + bucket % 4) * width + width - 1;
+    }
+
+    void Add(uint64_t v) {
+        counts[Bucket(v)]++;
+        samples++;
+        sum += v;
+        if (v > maxValue) maxValue = v;
+    }
+
+    // Giá trị tại phân vị p (0..1), làm tròn lên theo ngăn, không vượt quá max thật
+    uint64_t Percentile(double p) const {
+        if (samples == 0) return 0;
+        uint64_t rank = (uint64_t)(p * (samples - 1)) + 1, seen = 0;
+        for (int i = 0; i < BUCKETS; i++) {
+            seen += counts[i];
+            if (seen >= rank) return BucketTop(i) < maxValue ? BucketTop(i) : maxValue;
+        }
+        return maxValue;
+    }
+
+    double Mean() const { return samples ? (double)sum / samples : 0.0; }
+};
+
+class ProfileScope;
+
+class Profiler {
+public:
+    Profiler() { Reset(); }
+
+    void Reset() {
+        for (LogHistogram& h : phases) h = LogHistogram();
+        tickInterval = LogHistogram();
+        tickJitter = LogHistogram();
+        hasLastTick = false;
+        startClock = ProfileClock();
+        startTime = std::chrono::steady_clock::now();
+        lastOverlay = startTime;
+    }
+
+    // Gọi mỗi tick với khoảng cách mong đợi: ghi khoảng cách thật và độ lệch (micro giây)
+    void Tick(double expectedMs) {
+        auto now = std::chrono::steady_clock::now();
+        if (hasLastTick) {
+            double us = std::chrono::duration<double, std::micro>(now - lastTick).count();
+            double dev = us - expectedMs * 1000.0;
+            tickInterval.Add((uint64_t)us);
+            tickJitter.Add((uint64_t)(dev < 0 ? -dev : dev));
+        }
+        lastTick = now;
+        hasLastTick = true;
+    }
+
+    // Bỏ khoảng cách tới tick kế tiếp (tạm dừng, hiệu ứng qua màn): không phải độ lệch của nhịp
+    void SkipTick() { hasLastTick = false; }
+
+    // Số đơn vị ProfileClock trong một micro giây, hiệu chuẩn từ lúc Reset
+    double ClockPerMicro() const {
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - startTime).count();
+        uint64_t clocks = ProfileClock() - startClock;
+        return us > 0 && clocks > 0 ? clocks / us : 1.0;
+    }
+
+    std::string Summary() const {
+        double perUs = ClockPerMicro();
+        uint64_t total = 0;
+        for (const LogHistogram& h : phases) total += h.sum;
+
+        std::string out;
+        char line[160];
+        snprintf(line, sizeof(line), "%-9s %9s %10s %6s %9s %9s %9s %9s %9s\n",
+            "phase", "count", "total ms", "%", "mean us", "p50 us", "p90 us", "p99 us", "max us");
+        out += line;
+        for (int p = 0; p < PHASE_COUNT; p++) {
+            const LogHistogram& h = phases[p];
+            snprintf(line, sizeof(line), "%-9s %9llu %10.1f %6.1f %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+                PhaseName(p), (unsigned long long)h.samples, h.sum / perUs / 1000.0,
+                total ? 100.0 * h.sum / total : 0.0, h.Mean() / perUs,
+                h.Percentile(0.5) / perUs, h.Percentile(0.9) / perUs, h.Percentile(0.99) / perUs, h.maxValue / perUs);
+            out += line;
+        }
+        snprintf(line, sizeof(line), "ticks %llu, interval mean %.1f ms, jitter mean %.0f us p50 %llu p99 %llu max %llu us\n",
+            (unsigned long long)tickInterval.samples, tickInterval.Mean() / 1000.0, tickJitter.Mean(),
+            (unsigned long long)tickJitter.Percentile(0.5), (unsigned long long)tickJitter.Percentile(0.99),
+            (unsigned long long)tickJitter.maxValue);
+        out += line;
+        return out;
+    }
+
+    // Một dòng ngắn để vẽ lên màn hình chơi
+    std::string OverlayLine() const {
+        double perUs = ClockPerMicro();
+        char line[160];
+        snprintf(line, sizeof(line), "sim p99 %.0fus  render p99 %.0fus  present p99 %.0fus  jitter p99 %lluus",
+            phases[PHASE_SIMULATE].Percentile(0.99) / perUs, phases[PHASE_RENDER].Percentile(0.99) / perUs,
+            phases[PHASE_PRESENT].Percentile(0.99) / perUs, (unsigned long long)tickJitter.Percentile(0.99));
+        return line;
+    }
+
+    // Đã qua intervalMs kể từ lần trước trả về true
+    bool OverlayDue(int intervalMs) {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastOverlay < std::chrono::milliseconds(intervalMs)) return false;
+        lastOverlay = now;
+        return true;
+    }
+
+    bool Dump(const std::string& path) const {
+        FILE* f = fopen(path.c_str(), "w");
+        if (!f) return false;
+        std::string s = Summary();
+        bool ok = fwrite(s.data(), 1, s.size(), f) == s.size();
+        return fclose(f) == 0 && ok;
+    }
+
+    LogHistogram phases[PHASE_COUNT];  // Thời gian riêng của mỗi lần vào pha, đơn vị ProfileClock
+    LogHistogram tickInterval;         // Khoảng cách giữa hai tick (micro giây)
+    LogHistogram tickJitter;           // |khoảng cách thật - khoảng cách mong đợi| (micro giây)
+
+private:
+    friend class ProfileScope;
+    ProfileScope* current = nullptr;   // Pha đang chạy trong cùng luồng (vòng lặp game chỉ có một)
+    uint64_t startClock = 0;
+    std::chrono::steady_clock::time_point startTime, lastTick, lastOverlay;
+    bool hasLastTick = false;
+};
+
+inline Profiler& GlobalProfiler() {
+    static Profiler profiler;
+    return profiler;
+}
+
+// Đo một pha tới hết khối lệnh; pha cha đang chạy được tạm dừng tới khi khối này kết thúc
+class ProfileScope {
+public:
+    explicit ProfileScope(int phase) : phase(phase), parent(GlobalProfiler().current) {
+        uint64_t now = ProfileClock();
+        if (parent) parent->elapsed += now - parent->start;
+        GlobalProfiler().current = this;
+        start = now;
+    }
+
+    ~ProfileScope() {
+        uint64_t now = ProfileClock();
+        elapsed += now - start;
+        Profiler& profiler = GlobalProfiler();
+        profiler.phases[phase].Add(elapsed);
+        profiler.current = parent;
+        if (parent) parent->start = now;
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    int phase;
+    ProfileScope* parent;
+    uint64_t start = 0;
+    uint64_t elapsed = 0;
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+#define PROFILE_PHASE(phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(phase)
+#define PROFILE_TICK(expectedMs) GlobalProfiler().Tick(expectedMs)
+#define PROFILE_SKIP_TICK() GlobalProfiler().SkipTick()
+#define PROFILE_RESET() GlobalProfiler().Reset()
+#define PROFILE_DUMP(path) GlobalProfiler().Dump(path)
+
+#else
+
+#define PROFILE_PHASE(phase) ((void)0)
+#define PROFILE_TICK(expectedMs) ((void)0)
+#define PROFILE_SKIP_TICK() ((void)0)
+#define PROFILE_RESET() ((void)0)
+#define PROFILE_DUMP(path) ((void)0)
+
+#endif
@@ -0,0 +1,36 @@
+// Random.h — Bộ sinh số ngẫu nhiên PCG32 (XSH-RR) nhỏ, nhanh, tái lập được theo seed
+// Mỗi ván giữ một bộ sinh riêng thay cho rand()/srand() toàn cục
+
+#pragma once
+
+#include <cstdint>
+
+struct Pcg32 {
+    uint64_t state = 0x853c49e6748fea9bULL;
+    static const uint64_t INCREMENT = 0xda3e39cb94b95bdbULL; // Một luồng cố định, lẻ
+
+    void Seed(uint64_t seed) {
+        state = 0;
+        Next();
+        state += seed;
+        Next();
+    }
+
+    uint32_t Next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + INCREMENT;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // 0..n-1 bằng phép nhân 64 bit (Lemire), không chia; độ lệch < n / 2^32
+    uint32_t Below(uint32_t n) {
+        return (uint32_t)(((uint64_t)Next() * n) >> 32);
+    }
+
+    // [0, 1)
+    double NextDouble() {
+        return Next() * (1.0 / 4294967296.0);
+    }
+};
@@ -0,0 +1,152 @@
+// Replay.cpp — Ghi, lưu và phát lại replay
+
+#include <fstream>
+#include <utility>
+#include "Replay.h"
+#include "MappedFile.h"
+#include "ByteIO.h"
+
+using namespace std;
+
+static const uint8_t REPLAY_MAGIC[4] = { 'S', 'N', 'K', 'R' };
+static const size_t REPLAY_HEADER_SIZE = 16;
+
+// ===== RECORDING =====
+void ReplayRecorder::Begin(const SnakeSim& sim, uint64_t seed) {
+    replay = Replay();
+    replay.seed = seed;
+    replay.mode = sim.mode;
+    replay.keepLengthWhenLevelUp = sim.keepLengthWhenLevelUp;
+    replay.levelHash = LevelSetHash(sim.levels ? *sim.levels : DefaultLevelMaps());
+    lastDir = -1;
+    lastChange = 0;
+    active = true;
+}
+
+void ReplayRecorder::Record(int dir) {
+    if (!active) return;
+    if (dir != lastDir) {
+        ByteWriter w{ replay.moves };
+        w.Var(((replay.ticks - lastChange) << 2) | (uint64_t)(dir & 3));
+        lastDir = dir;
+        lastChange = replay.ticks;
+    }
+    replay.ticks++;
+}
+
+void ReplayRecorder::Finish(const SnakeSim& sim) {
+    if (!active) return;
+    replay.finalScore = sim.score;
+    replay.finalLength = (int)sim.snake.size();
+    replay.finalLevel = sim.speedLevel;
+    replay.finalRng = sim.rng.state;
+    active = false;
+}
+
+// ===== PLAYBACK =====
+bool RunReplay(const Replay& replay, SnakeSim& sim, const vector<MapData>* levels) {
+    sim.levels = levels;
+    sim.mode = replay.mode;
+    sim.keepLengthWhenLevelUp = replay.keepLengthWhenLevelUp;
+    sim.Reset(replay.seed);
+
+    ByteReader r{ replay.moves.data(), replay.moves.data() + replay.moves.size() };
+    int dir = sim.moving;
+    uint64_t nextChange = 0;
+    int nextDir = dir;
+    bool pending = r.Left() > 0;
+    if (pending) {
+        uint64_t v = r.Var();
+        nextChange = v >> 2;
+        nextDir = (int)(v & 3);
+    }
+
+    for (uint64_t t = 0; t < replay.ticks; t++) {
+        if (pending && t == nextChange) {
+            dir = nextDir;
+            pending = r.Left() > 0;
+            if (pending) {
+                uint64_t v = r.Var();
+                nextChange = t + (v >> 2);
+                nextDir = (int)(v & 3);
+            }
+        }
+        sim.Step(dir);
+    }
+
+    return r.ok && !pending &&
+        sim.score == replay.finalScore &&
+        (int)sim.snake.size() == replay.finalLength &&
+        sim.speedLevel == replay.finalLevel &&
+        sim.rng.state == replay.finalRng;
+}
+
+bool ReplayLevelsMatch(const Replay& replay, const vector<MapData>* levels) {
+    return replay.levelHash == 0 || replay.levelHash == LevelSetHash(levels ? *levels : DefaultLevelMaps());
+}
+
+// ===== FILES =====
+bool SaveReplay(const Replay& replay, const string& path) {
+    vector<uint8_t> buf;
+    buf.reserve(REPLAY_HEADER_SIZE + 64 + replay.moves.size());
+    ByteWriter w{ buf };
+    for (uint8_t c : REPLAY_MAGIC) w.U8(c);
+    w.U16(REPLAY_VERSION);
+    w.U16((uint32_t)REPLAY_HEADER_SIZE);
+    w.U32(0);
+    w.U32(0);
+
+    w.U64(replay.seed);
+    w.U8(replay.mode);
+    w.U8(replay.keepLengthWhenLevelUp);
+    w.U32(replay.levelHash);
+    w.Var(replay.ticks);
+    w.U32((uint32_t)replay.finalScore);
+    w.U32((uint32_t)replay.finalLength);
+    w.U32((uint32_t)replay.finalLevel);
+    w.U64(replay.finalRng);
+    w.Var(replay.moves.size());
+    buf.insert(buf.end(), replay.moves.begin(), replay.moves.end());
+
+    size_t payloadSize = buf.size() - REPLAY_HEADER_SIZE;
+    w.Put32(8, (uint32_t)payloadSize);
+    w.Put32(12, Fnv1a(buf.data() + REPLAY_HEADER_SIZE, payloadSize));
+
+    ofstream fo(path, ios::binary | ios::trunc);
+    if (!fo) return false;
+    fo.write((const char*)buf.data(), (streamsize)buf.size());
+    return (bool)fo;
+}
+
+bool LoadReplay(Replay& replay, const string& path) {
+    MappedFile file;
+    if (!file.Open(path) || file.size < REPLAY_HEADER_SIZE) return false;
+    for (size_t i = 0; i < 4; i++) if (file.data[i] != REPLAY_MAGIC[i]) return false;
+
+    ByteReader h{ file.data + 4, file.data + REPLAY_HEADER_SIZE };
+    uint32_t version = h.U16();
+    uint32_t headerSize = h.U16();
+    uint32_t payloadSize = h.U32();
+    uint32_t checksum = h.U32();
+    if (version < 1 || version > REPLAY_VERSION || headerSize != REPLAY_HEADER_SIZE) return false;
+    if (payloadSize != file.size - headerSize) return false;
+    if (Fnv1a(file.data + headerSize, payloadSize) != checksum) return false;
+
+    ByteReader r{ file.data + headerSize, file.data + file.size };
+    Replay next;
+    next.seed = r.U64();
+    next.mode = (int)r.U8();
+    next.keepLengthWhenLevelUp = r.U8() != 0;
+    if (version >= 2) next.levelHash = r.U32();  // Bản 1 không có: levelHash = 0
+    next.ticks = r.Var();
+    next.finalScore = (int)r.U32();
+    next.finalLength = (int)r.U32();
+    next.finalLevel = (int)r.U32();
+    next.finalRng = r.U64();
+    uint64_t movesSize = r.Var();
+    if (!r.ok || movesSize != r.Left()) return false;
+    next.moves.assign(r.p, r.end);
+
+    replay = std::move(next);
+    return true;
+}
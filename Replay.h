@@ -0,0 +1,57 @@
+// Replay.h — Ghi lại một ván theo từng tick và phát lại đúng y hệt qua SnakeSim::Step
+//
+// Một ván được xác định hoàn toàn bởi seed, cấu hình và hướng đi ở mỗi tick, nên chỉ cần lưu
+// các lần đổi hướng: varint((số tick kể từ lần đổi trước << 2) | hướng). Kết quả cuối ván
+// (điểm, độ dài, level, trạng thái RNG) đi kèm để kiểm tra khi phát lại. Từ bản 2 kèm LevelSetHash
+// của bộ map lúc ghi: phát lại trên bộ map khác (maps/*.map đã sửa) bị từ chối thay vì báo lệch.
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "SnakeSim.h"
+
+const uint16_t REPLAY_VERSION = 2;  // 2: thêm levelHash
+
+struct Replay {
+    // Cấu hình đầu ván
+    uint64_t seed = 0;
+    int mode = MODE_CLASSIC;
+    bool keepLengthWhenLevelUp = true;
+    uint32_t levelHash = 0;      // LevelSetHash của bộ map lúc ghi; 0: không rõ (file bản 1)
+
+    uint64_t ticks = 0;          // Số lần gọi Step
+    std::vector<uint8_t> moves;  // Các lần đổi hướng, mã hóa varint
+
+    // Kết quả cuối ván
+    int finalScore = 0;
+    int finalLength = 0;
+    int finalLevel = 1;
+    uint64_t finalRng = 0;
+};
+
+// Gọi Begin ngay sau sim.Reset(seed), Record(dir) trước mỗi sim.Step(dir), Finish khi hết ván
+struct ReplayRecorder {
+    Replay replay;
+    bool active = false;
+
+    void Begin(const SnakeSim& sim, uint64_t seed);
+    void Record(int dir);
+    void Finish(const SnakeSim& sim);
+
+private:
+    int lastDir = -1;
+    uint64_t lastChange = 0;
+};
+
+// Chơi lại toàn bộ ván trên sim (levels = nullptr: bộ map mặc định) với tốc độ tối đa
+// Trả về true nếu kết quả khớp với kết quả đã ghi. Không tự kiểm tra levelHash (băm cả bộ map mỗi lần
+// chạy): người gọi so với ReplayLevelsMatch một lần trước khi phát lại
+bool RunReplay(const Replay& replay, SnakeSim& sim, const std::vector<MapData>* levels = nullptr);
+
+// Replay ghi trên đúng bộ map này (levels = nullptr: bộ map mặc định); replay bản 1 luôn đúng
+bool ReplayLevelsMatch(const Replay& replay, const std::vector<MapData>* levels = nullptr);
+
+bool SaveReplay(const Replay& replay, const std::string& path);
+bool LoadReplay(Replay& replay, const std::string& path);
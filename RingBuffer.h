@@ -0,0 +1,69 @@
+// RingBuffer.h — Bộ đệm vòng sức chứa cố định cho thân rắn
+// Thêm đầu (push_back) và bỏ đuôi (pop_front) đều O(1), không cấp phát lại khi đang chơi
+
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) { reserve(capacity); }
+
+    // Sức chứa được làm tròn lên lũy thừa của 2 để lấy chỉ số bằng phép AND
+    void reserve(size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        if (cap <= data.size()) return;
+
+        std::vector<T> grown(cap);
+        for (size_t i = 0; i < count; i++) grown[i] = (*this)[i];
+        data.swap(grown);
+        mask = cap - 1;
+        start = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t capacity() const { return data.size(); }
+    bool empty() const { return count == 0; }
+    void clear() { start = 0; count = 0; }
+
+    void push_back(const T& value) {
+        // Chỉ tăng sức chứa khi dữ liệu nạp từ ngoài vượt quá kích thước bàn chơi
+        if (count == data.size()) reserve(count + 1);
+        data[(start + count) & mask] = value;
+        count++;
+    }
+    void pop_front() { start = (start + 1) & mask; count--; }
+    void pop_back() { count--; }
+
+    // Chỉ số 0 là phần tử cũ nhất (đuôi rắn), size()-1 là mới nhất (đầu rắn)
+    T& operator[](size_t i) { return data[(start + i) & mask]; }
+    const T& operator[](size_t i) const { return data[(start + i) & mask]; }
+    T& front() { return data[start]; }
+    const T& front() const { return data[start]; }
+    T& back() { return data[(start + count - 1) & mask]; }
+    const T& back() const { return data[(start + count - 1) & mask]; }
+
+    class const_iterator {
+    public:
+        const_iterator(const RingBuffer* rb, size_t i) : rb(rb), i(i) {}
+        const T& operator*() const { return (*rb)[i]; }
+        const T* operator->() const { return &(*rb)[i]; }
+        const_iterator& operator++() { i++; return *this; }
+        bool operator!=(const const_iterator& o) const { return i != o.i; }
+        bool operator==(const const_iterator& o) const { return i == o.i; }
+    private:
+        const RingBuffer* rb;
+        size_t i;
+    };
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, count); }
+
+private:
+    std::vector<T> data;
+    size_t mask = 0;
+    size_t start = 0;
+    size_t count = 0;
+};
@@ -0,0 +1,990 @@
+// SnakeConsole.cpp — Bản console (Windows console hoặc terminal VT trên Linux/macOS)
+// Vẽ, nhập phím và âm thanh đi qua Terminal.h nên file này không phụ thuộc nền tảng
+
+#include <iostream>
+#include <vector>
+#include <ctime>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cctype>
+#include <functional>
+#include <algorithm>
+#include "SnakeSim.h"
+#include "FrameBuffer.h"
+#include "Terminal.h"
+#include "SnakeSave.h"
+#include "MappedFile.h"
+#include "HighScoreStore.h"
+#include "Replay.h"
+#include "TurnBuffer.h"
+#include "InputThread.h"
+#include "CyclePilot.h"
+#include "Profiler.h"
+#include "NetProtocol.h"
+#include "NetSocket.h"
+#include "MapPack.h"
+
+using namespace std;
+
+// ===== CONSTANTS & ENUMS =====
+// MAX_SPEED, FOOD_COUNT, DIR_*, MODE_* nằm trong SnakeSim.h
+const string HIGHSCORE_FILE = "highscore.txt";
+const string REPLAY_FILE = "last.replay";  // Ván gần nhất, phát lại bằng tools/ReplayRunner
+// Map lớn nhất nạp từ levels.pack: bàn lớn hơn terminal chỉ hiện một vùng quanh đầu rắn, nhưng bot BFS
+// và mỗi lần cuộn khung vẫn tốn theo diện tích bàn
+const int MAX_MAP_WIDTH = 512;
+const int MAX_MAP_HEIGHT = 256;
+
+// ===== STRUCTS & CLASSES =====
+struct GameObject {
+    Point position;
+    char symbol;
+    int color;
+    bool active;
+    string type;
+
+    GameObject(Point pos = { 0,0 }, char sym = ' ', int col = 7, string t = "default")
+        : position(pos), symbol(sym), color(col), active(true), type(t) {
+    }
+};
+
+struct SnakeSegment : GameObject {
+    SnakeSegment(Point pos) : GameObject(pos, 'O', 10, "snake") {}
+};
+
+struct Food : GameObject {
+    int value;
+    Food(Point pos, int val = 10) : GameObject(pos, '@', 12, "food"), value(val) {}
+};
+
+struct PowerUp : GameObject {
+    string effect;
+    int duration;
+    PowerUp(Point pos, string eff, int dur) : GameObject(pos, '*', 14, "powerup"), effect(eff), duration(dur) {}
+};
+
+// ===== GLOBAL VARIABLES =====
+// Game State
+int state = 0;
+TurnBuffer turns;               // Các lượt rẽ bấm giữa hai tick, mỗi tick thực hiện một lượt
+InputThread input;              // Luồng đọc bàn phím trong lúc chơi
+bool autopilot = false;         // Bot tự lái thay người chơi (Settings D), dùng để chạy thử lâu và làm mốc
+CyclePilot pilot;               // Theo chu trình Hamilton nếu map có, không thì tìm đường BFS
+SnakeSim game;                  // Luật chơi và trạng thái ván (rắn, mồi, cổng, điểm, level)
+ReplayRecorder recorder;        // Ghi hướng đi từng tick của ván đang chơi
+
+// Screen & Map
+int WIDTH_CONSOLE = 70;
+int HEIGH_CONSOLE = 20;
+string lastHud;                 // Dòng trạng thái đang hiển thị, chỉ vẽ lại khi thay đổi
+FrameBuffer frame;              // Khung chơi (viền, tường, rắn, mồi, cổng), chỉ ghi ô thay đổi
+// Những gì frame đang chứa: mỗi tick chỉ vẽ đầu mới, xóa đuôi cũ và cập nhật ô mồi/cổng
+bool frameStale = true;         // Lần ComposeFrame kế tiếp dựng lại toàn bộ (đổi màn, đổi kích thước, chữ đè lên khung)
+int viewX = 0, viewY = 0;       // Ô của bàn nằm ở góc trên trái khung (khác 0 khi bàn lớn hơn terminal)
+const MapData* drawnMap = nullptr;
+Point drawnHead, drawnTail, drawnNext;  // drawnNext: đoạn ngay sau đuôi
+size_t drawnLength = 0;
+Point drawnFood{ -1, -1 }, drawnGate{ -1, -1 };  // -1: không có
+vector<MapData> levelMaps;      // Nạp một lần lúc khởi động: levels.pack nếu có, không thì bộ dựng sẵn
+uint32_t levelHash = 0;         // LevelSetHash(levelMaps), gửi cho máy chủ để đối chiếu bộ map
+int currentLevelMap = 0;
+
+// Score System
+int highScore = 0;
+HighScoreStore highScores;      // Bảng xếp hạng (nhật ký highscores.txt + chỉ mục highscores.txt.idx)
+
+// ===== FORWARD DECLARATIONS =====
+void LoadLevelMaps();
+MapData& GetCurrentMap();
+void DrawMapObstacles();
+void ResetData();
+void GameLoop();
+void SaveHighScoreEntry(const string& playerName, int score, int level);
+void ShowHighScores();
+vector<HighScoreEntry> LoadHighScores();
+
+// ===== CONSOLE UTILITIES =====
+// GotoXY, SetColor, HideCursor... nằm trong Terminal.h
+
+// Vẽ text có màu tại vị trí (x, y)
+void DrawColoredText(int x, int y, const string& text, int color) {
+    SetColor(color);
+    GotoXY(x, y);
+    WriteText(text);
+    SetColor(7); // Reset về màu trắng
+}
+
+// Vẽ khung viền trò chơi với ký tự 'X'
+void DrawBoard(int x, int y, int w, int h) {
+    GotoXY(x, y); WriteText(string(w + 1, 'X')); // Viền trên
+    GotoXY(x, h + y); WriteText(string(w + 1, 'X')); // Viền dưới
+    for (int i = y + 1; i < h + y; i++) {
+        GotoXY(x, i); WriteText("X"); // Viền trái
+        GotoXY(x + w, i); WriteText("X"); // Viền phải
+    }
+}
+
+// Kích thước khung chơi: cả bàn cộng viền nếu vừa terminal, không thì cắt theo terminal
+// (chừa 2 hàng cho dòng trống và dòng trạng thái)
+void ViewSize(int& w, int& h) {
+    w = WIDTH_CONSOLE + 1;
+    h = HEIGH_CONSOLE + 1;
+    int termW, termH;
+    if (GetTerminalSize(termW, termH)) {
+        w = max(1, min(w, termW));
+        h = max(1, min(h, termH - 2));
+    }
+}
+
+// Khung viền của menu, bảng điểm, cài đặt theo kích thước khung chơi
+void DrawScreenBoard() {
+    int w, h;
+    ViewSize(w, h);
+    DrawBoard(0, 0, w - 1, h - 1);
+}
+
+// Hiển thị thông tin ở phía dưới màn hình game
+void PrintBottom(const string& s, bool clearLine = true) {
+    int w, h;
+    ViewSize(w, h);
+    if (clearLine) {
+        GotoXY(0, h + 1);
+        WriteText(string(120, ' ')); // Xóa dòng cũ
+    }
+    GotoXY(0, h + 1);
+    WriteText(s);
+    FlushOutput();
+}
+
+// ===== INPUT HANDLING =====
+// Chuyển đổi phím bấm thành hướng di chuyển (hỗ trợ WASD và phím mũi tên)
+int GetDirectionFromKey(int key) {
+    switch (key) {
+    case 'A': case 'a': return DIR_LEFT;   // A hoặc a = trái
+    case 'D': case 'd': return DIR_RIGHT;  // D hoặc d = phải
+    case 'W': case 'w': return DIR_UP;     // W hoặc w = lên
+    case 'S': case 's': return DIR_DOWN;   // S hoặc s = xuống
+    case KEY_UP: return DIR_UP;       // Phím mũi tên lên
+    case KEY_DOWN: return DIR_DOWN;   // Phím mũi tên xuống
+    case KEY_LEFT: return DIR_LEFT;   // Phím mũi tên trái
+    case KEY_RIGHT: return DIR_RIGHT; // Phím mũi tên phải
+    default: return -1;        // Phím không hợp lệ
+    }
+}
+
+// ===== SOUND SYSTEM =====
+// Phát âm thanh cho các sự kiện trong game (ăn mồi, lên level, chết)
+void PlayGameSound(const string& sound) {
+    if (sound == "eat") PlayTone(800, 100);        // Ăn mồi: 800Hz, 100ms
+    else if (sound == "levelup") PlayTone(1000, 200); // Lên level: 1000Hz, 200ms
+    else if (sound == "death") PlayTone(300, 500);     // Chết: 300Hz, 500ms
+}
+
+// ===== SCORE SYSTEM =====
+// Đọc điểm số cao nhất từ file
+void LoadHighScore() {
+    ifstream file(HIGHSCORE_FILE);
+    if (file) {
+        file >> highScore;
+    }
+}
+
+// Lưu điểm số cao nhất vào file nếu phá kỷ lục
+void SaveHighScore() {
+    if (game.score > highScore) {
+        highScore = game.score;
+        ofstream file(HIGHSCORE_FILE);
+        file << highScore;
+    }
+}
+
+// Cập nhật kỷ lục theo điểm số hiện tại (điểm được cộng trong SnakeSim)
+void UpdateScore() {
+    if (game.score > highScore) {
+        highScore = game.score;
+    }
+}
+
+// ===== HIGH SCORE SYSTEM =====
+// Lưu thông tin game vào bảng xếp hạng
+void SaveHighScoreEntry(const string& playerName, int score, int level) {
+    // Lấy thời gian hiện tại (localtime_s trên MSVC, localtime_r trên POSIX, đều an toàn luồng)
+    time_t now = time(0);
+    struct tm timeinfo;
+    char timeStr[20];
+
+#ifdef _WIN32
+    bool ok = localtime_s(&timeinfo, &now) == 0;
+#else
+    bool ok = localtime_r(&now, &timeinfo) != nullptr;
+#endif
+    if (ok) {
+        strftime(timeStr, sizeof(timeStr), "%d/%m/%Y", &timeinfo);
+    }
+    else {
+        snprintf(timeStr, sizeof(timeStr), "Unknown");
+    }
+
+    highScores.Add(HighScoreEntry(playerName, score, level, timeStr));
+}
+
+// Top 15 lấy thẳng từ chỉ mục, không đọc lại nhật ký
+vector<HighScoreEntry> LoadHighScores() {
+    return highScores.Top(15);
+}
+
+// Hiển thị bảng xếp hạng top 15
+void ShowHighScores() {
+    ClearScreen();
+    DrawScreenBoard();
+    int w, h;
+    ViewSize(w, h);
+
+    DrawColoredText((w - 1) / 2 - 8, 2, "=== TOP 15 HIGH SCORES ===", 14);
+
+    vector<HighScoreEntry> scores = LoadHighScores();
+
+    GotoXY(3, 4);  WriteText("Rank  Player Name       Score    Level   Date");
+    GotoXY(3, 5);  WriteText("====  ==============  =======  ======  ==========");
+
+    int displayCount = min(15, (int)scores.size());
+    for (int i = 0; i < displayCount; i++) {
+        char row[128];
+        snprintf(row, sizeof(row), "%2d    %-14s  %7d  %6d  %s",
+            i + 1,
+            scores[i].playerName.c_str(),
+            scores[i].score,
+            scores[i].level,
+            scores[i].date.c_str());
+        GotoXY(3, 6 + i);
+        WriteText(row);
+    }
+
+    if (scores.empty()) {
+        GotoXY((w - 1) / 2 - 10, 10);
+        WriteText("No high scores yet!");
+    }
+
+    PrintBottom("Press any key to return to menu...");
+    GetKey();
+}
+
+// ===== MAP SYSTEM =====
+// Đọc gói màn chơi (MapPackCompiler dịch từ maps/*.map) qua mmap; thiếu hoặc hỏng thì dùng bộ map dựng sẵn
+void LoadLevelMaps() {
+    MapPack pack;
+    bool loaded = pack.Open(LEVEL_PACK_FILE) && pack.LoadAll(levelMaps);
+    for (size_t i = 0; loaded && i < levelMaps.size(); i++)
+        loaded = levelMaps[i].width <= MAX_MAP_WIDTH && levelMaps[i].height <= MAX_MAP_HEIGHT;
+    if (!loaded) InitializeLevelMaps(levelMaps);
+    levelHash = LevelSetHash(levelMaps);
+    game.levels = &levelMaps;
+}
+
+// Lấy bản đồ tương ứng với level hiện tại
+MapData& GetCurrentMap() {
+    int mapIndex = (game.speedLevel - 1) % levelMaps.size(); // Lặp lại map khi hết
+    return levelMaps[mapIndex];
+}
+
+// Vẽ các chướng ngại vật của bản đồ hiện tại trong vùng khung đang hiện
+void DrawMapObstacles() {
+    MapData& currentMap = GetCurrentMap();
+    int x1 = min(currentMap.width, viewX + frame.width), y1 = min(currentMap.height, viewY + frame.height);
+
+    // Sử dụng GetTile an toàn
+    for (int y = viewY; y < y1; y++) {
+        for (int x = viewX; x < x1; x++) {
+            char tile = GetTile(currentMap, x, y);
+            if (tile == '#') {
+                frame.SetCell(x - viewX, y - viewY, '#', currentMap.backgroundColor); // Vẽ chướng ngại vật
+            }
+        }
+    }
+}
+
+// ===== DRAWING FUNCTIONS =====
+// Các hàm vẽ trong game chỉ ghi vào frame theo tọa độ bàn; PresentFrame() mới đưa ra màn hình.
+// Ô ngoài vùng khung đang hiện bị bỏ qua
+void DrawChar(int x, int y, char c) {
+    frame.SetCell(x - viewX, y - viewY, c);
+}
+
+void DrawSnake(char c) {
+    for (auto& p : game.snake) DrawChar(p.x, p.y, c);
+}
+
+// Ô mồi đang hiện, { -1, -1 } nếu không có
+Point VisibleFood() {
+    if (!game.foodVisible) return { -1, -1 };
+    if (game.foodIndex < 0 || game.foodIndex >= (int)game.foods.size()) return { -1, -1 };
+    return game.foods[game.foodIndex];
+}
+
+Point VisibleGate() {
+    return game.gateActive ? game.gatePos : Point{ -1, -1 };
+}
+
+void DrawFood() {
+    Point f = VisibleFood();
+    DrawChar(f.x, f.y, '@');
+}
+
+void DrawGate() {
+    Point g = VisibleGate();
+    DrawChar(g.x, g.y, 'G');
+}
+
+// Ghi lại trạng thái vừa vẽ để tick sau so sánh
+void RememberDrawn() {
+    size_t n = game.snake.size();
+    drawnMap = game.activeMap;
+    drawnHead = game.snake.back();
+    drawnTail = game.snake.front();
+    drawnNext = n > 1 ? game.snake[1] : drawnTail;
+    drawnLength = n;
+    drawnFood = VisibleFood();
+    drawnGate = VisibleGate();
+}
+
+// Rắn hiện tại có phải rắn đã vẽ đi thêm một bước không (thêm đầu, bỏ hoặc giữ đuôi)
+bool SnakeAdvancedOneStep() {
+    size_t n = game.snake.size();
+    if (n < 2 || drawnLength == 0 || game.snake[n - 2] != drawnHead) return false;
+    if (n == drawnLength) return game.snake.front() == drawnNext;      // Đi: đuôi cũ đã rời đi
+    if (n == drawnLength + 1) return game.snake.front() == drawnTail;  // Ăn: giữ đuôi
+    return false;
+}
+
+// Vị trí mới của khung theo một trục: giữ nguyên tới khi đầu rắn vào phần tư sát mép, rồi đặt đầu ở giữa
+int ScrollView(int view, int head, int size, int total) {
+    if (size >= total) return 0;
+    int margin = size / 4;
+    if (head - view < margin || head - view >= size - margin) view = head - size / 2;
+    return max(0, min(view, total - size));
+}
+
+// Bàn lớn hơn terminal: khung chỉ hiện một vùng quanh đầu rắn; cuộn thì dựng lại cả khung
+void UpdateViewport() {
+    Point head = game.snake.back();
+    int x = ScrollView(viewX, head.x, frame.width, WIDTH_CONSOLE + 1);
+    int y = ScrollView(viewY, head.y, frame.height, HEIGH_CONSOLE + 1);
+    if (x != viewX || y != viewY) {
+        viewX = x;
+        viewY = y;
+        frameStale = true;
+    }
+}
+
+// Dựng toàn bộ khung chơi vào back buffer
+void ComposeFullFrame() {
+    frame.Clear();
+    for (int x = 0; x <= WIDTH_CONSOLE; x++) {
+        DrawChar(x, 0, 'X');
+        DrawChar(x, HEIGH_CONSOLE, 'X');
+    }
+    for (int y = 1; y < HEIGH_CONSOLE; y++) {
+        DrawChar(0, y, 'X');
+        DrawChar(WIDTH_CONSOLE, y, 'X');
+    }
+    DrawMapObstacles();
+    DrawSnake('O');
+    DrawFood();
+    DrawGate();
+    frameStale = false;
+}
+
+// Viền và tường chỉ vẽ một lần mỗi màn; tick thường chỉ chạm đầu mới, đuôi cũ, mồi và cổng
+void ComposeFrame() {
+    if (game.snake.empty()) return;
+    UpdateViewport();
+    if (frameStale || game.activeMap != drawnMap || !SnakeAdvancedOneStep()) {
+        ComposeFullFrame();
+        RememberDrawn();
+        return;
+    }
+    // Xóa trước, vẽ sau: đầu mới có thể nằm đúng ô mồi vừa ăn hoặc ô đuôi vừa rời
+    Point food = VisibleFood(), gate = VisibleGate();
+    if (drawnFood != food) DrawChar(drawnFood.x, drawnFood.y, ' ');
+    if (drawnGate != gate) DrawChar(drawnGate.x, drawnGate.y, ' ');
+    if (game.snake.size() == drawnLength) DrawChar(drawnTail.x, drawnTail.y, ' ');
+    DrawChar(game.snake.back().x, game.snake.back().y, 'O');
+    DrawFood();
+    DrawGate();
+    RememberDrawn();
+}
+
+// Chỉ xóa màn hình khi kích thước khung chơi thay đổi; khung không lớn hơn terminal
+void FitFrameToBoard() {
+    int w, h;
+    ViewSize(w, h);
+    if (frame.width != w || frame.height != h) {
+        ClearScreen();
+        frame.Resize(w, h);
+        lastHud.clear();
+        frameStale = true;
+    }
+}
+
+// Vẽ lại khung chơi
+void RefreshScreen() {
+    FitFrameToBoard();
+    frameStale = true;
+    ComposeFrame();
+    PresentFrame(frame);
+}
+
+// ===== ANIMATIONS =====
+void BlinkSnake(int times = 4, int delayMs = 80) {
+    for (int i = 0; i < times; i++) {
+        DrawSnake(' '); PresentFrame(frame); SleepMs(delayMs);
+        DrawSnake('O'); PresentFrame(frame); SleepMs(delayMs);
+    }
+}
+
+void GateWave(const Point& gate, int times = 3, int delayMs = 70) {
+    for (int i = 0; i < times; i++) {
+        DrawChar(gate.x, gate.y, '#'); PresentFrame(frame); SleepMs(delayMs);
+        DrawChar(gate.x, gate.y, 'G'); PresentFrame(frame); SleepMs(delayMs);
+    }
+}
+
+// ===== GAME LOGIC =====
+// Hiệu ứng qua màn; SnakeSim đã đổi level, đặt lại rắn và sinh mồi mới
+void LevelUp(const Point& gate) {
+    PROFILE_PHASE(PHASE_EFFECTS);
+    PROFILE_SKIP_TICK(); // Tick sau màn chuyển cấp không tính vào độ lệch nhịp
+    GateWave(gate);
+    PlayGameSound("levelup");
+
+    MapData& newMap = GetCurrentMap();
+    WIDTH_CONSOLE = newMap.width;
+    HEIGH_CONSOLE = newMap.height;
+
+    // Không xóa màn hình: chỉ các ô khác giữa hai map được ghi lại
+    FitFrameToBoard();
+    ComposeFrame();
+    frame.SetText(frame.width / 2 - 8, frame.height / 2, "LEVEL " + to_string(game.speedLevel), 14);
+    frame.SetText(frame.width / 2 - 10, frame.height / 2 + 1, "Theme: " + newMap.themeName, 11);
+    PresentFrame(frame);
+    frameStale = true; // Tick sau dựng lại khung để xóa chữ
+    SleepMs(1500);
+}
+
+void ProcessDead() {
+    state = 0;
+    input.Stop(); // Trả bàn phím cho ReadLine và lời nhắc chơi lại
+    PROFILE_PHASE(PHASE_EFFECTS);
+    PlayGameSound("death");
+    SaveHighScore();
+
+    BlinkSnake();
+
+    // Nhập tên để lưu vào bảng xếp hạng
+    if (game.score > 0) {
+        PrintBottom("Enter your name for high score table: ");
+        string playerName;
+
+        // Hiện cursor để nhập tên
+        HideCursor(false);
+        playerName = ReadLine();
+        HideCursor(true);
+
+        // Giới hạn độ dài tên
+        if (playerName.length() > 14) {
+            playerName = playerName.substr(0, 14);
+        }
+        if (playerName.empty()) {
+            playerName = "Anonymous";
+        }
+
+        SaveHighScoreEntry(playerName, game.score, game.speedLevel);
+
+        PrintBottom("Score saved! Final Score: " + to_string(game.score) +
+            (game.score == highScore ? " NEW HIGH SCORE!" : "") +
+            " Press Y to restart or any key to return menu.");
+    }
+    else {
+        PrintBottom("Dead! Final Score: " + to_string(game.score) +
+            " Press Y to restart or any key to return menu.");
+    }
+}
+
+void Step(int dir) {
+    Point gate = game.gatePos; // Giữ lại vị trí cổng cho hiệu ứng qua màn
+    recorder.Record(dir);
+    int events = game.Step(dir);
+    UpdateScore();
+
+    if (events & (EVT_DEAD | EVT_BOARD_FULL)) {
+        ProcessDead();
+        return;
+    }
+    if (events & EVT_EAT) PlayGameSound("eat");
+    if (events & EVT_LEVEL_UP) LevelUp(gate);
+}
+
+void ResetData() {
+    turns.Clear();
+    pilot.Reset();
+
+    game.levels = &levelMaps;  // Nạp một lần lúc khởi động (LoadLevelMaps), không dựng lại mỗi ván
+    // Seed theo thời gian + số ván để hai ván trong cùng một giây vẫn khác nhau
+    static uint64_t gamesStarted = 0;
+    uint64_t seed = ((uint64_t)time(nullptr) << 20) ^ (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count() ^ ++gamesStarted;
+    game.Reset(seed);
+    recorder.Begin(game, seed);
+
+    MapData& currentMap = GetCurrentMap();
+    WIDTH_CONSOLE = currentMap.width;
+    HEIGH_CONSOLE = currentMap.height;
+}
+
+// ===== SAVE/LOAD SYSTEM =====
+// Định dạng text cũ, giữ lại làm tùy chọn xuất (tên file .txt); không có điểm, mode, RNG
+bool ExportTextSave(const string& filename) {
+    ofstream fo(filename);
+    if (!fo) return false;
+    fo << WIDTH_CONSOLE << ' ' << HEIGH_CONSOLE << '\n';
+    fo << (int)game.moving << ' ' << (int)game.locked << ' ' << game.speedLevel << ' ' << state << '\n';
+    fo << game.keepLengthWhenLevelUp << ' ' << game.foodIndex << '\n';
+    fo << game.gateActive << ' ' << game.gatePos.x << ' ' << game.gatePos.y << '\n';
+
+    fo << game.snake.size() << '\n';
+    for (auto& p : game.snake) fo << p.x << ' ' << p.y << '\n';
+
+    fo << game.foods.size() << '\n';
+    for (auto& f : game.foods) fo << f.x << ' ' << f.y << '\n';
+    return true;
+}
+
+bool ImportTextSave(const string& filename) {
+    ifstream fi(filename);
+    if (!fi) return false;
+
+    int mv, lk;
+    fi >> WIDTH_CONSOLE >> HEIGH_CONSOLE;
+    fi >> mv >> lk >> game.speedLevel >> state;
+    game.moving = mv;
+    game.locked = lk;
+    fi >> game.keepLengthWhenLevelUp >> game.foodIndex;
+    fi >> game.gateActive >> game.gatePos.x >> game.gatePos.y;
+
+    size_t n; fi >> n; game.snake.clear(); game.snake.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        Point p; fi >> p.x >> p.y;
+        game.snake.push_back(p);
+    }
+
+    size_t m; fi >> m; game.foods.clear(); game.foods.reserve(m);
+    for (size_t i = 0; i < m; i++) {
+        Point f; fi >> f.x >> f.y;
+        game.foods.push_back(f);
+    }
+
+    // File cũ không lưu trạng thái hiển thị mồi: mồi ẩn khi cổng đang mở
+    game.levels = &levelMaps;
+    game.foodVisible = !game.gateActive;
+    game.alive = true;
+    game.RebuildOccupancy();
+    return true;
+}
+
+static bool HasTextExtension(const string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".txt") == 0;
+}
+
+// Mặc định lưu snapshot nhị phân đầy đủ; tên .txt thì xuất định dạng text cũ
+bool SaveToFile(const string& filename) {
+    if (HasTextExtension(filename)) return ExportTextSave(filename);
+    return SaveSnapshot(game, filename);
+}
+
+// Nhận ra snapshot qua magic, còn lại đọc như file text cũ
+bool LoadFromFile(const string& filename) {
+    game.levels = &levelMaps;
+    turns.Clear(); // Lượt rẽ đã bấm thuộc về ván đang chơi, không áp lên ván vừa nạp
+    pilot.Reset();
+
+    MappedFile file;
+    if (file.Open(filename) && IsSnapshot(file.data, file.size)) {
+        if (!DecodeSnapshot(game, file.data, file.size)) return false; // Hỏng hoặc khác phiên bản
+        MapData& currentMap = GetCurrentMap();
+        WIDTH_CONSOLE = currentMap.width;
+        HEIGH_CONSOLE = currentMap.height;
+        game.alive = true;
+        state = 1;
+        recorder.active = false; // Ván không còn bắt đầu từ seed đã ghi
+        return true;
+    }
+    file.Close();
+    if (!ImportTextSave(filename)) return false;
+    recorder.active = false;
+    return true;
+}
+
+// ===== GAME LOOP =====
+// Vẽ dòng trạng thái khi có giá trị thay đổi
+void DrawHud() {
+    string hud = "Level: " + to_string(game.speedLevel) + "  Length: " + to_string(game.snake.size()) +
+        "  Score: " + to_string(game.score) + "  High: " + to_string(highScore) +
+        (game.gateActive ? "   Gate: ON" : "   Gate: OFF") + (autopilot ? "   AUTO" : "");
+    if (hud == lastHud) return;
+    PrintBottom(hud, hud.size() < lastHud.size()); // Dòng ngắn hơn thì xóa phần thừa
+    lastHud = hud;
+}
+
+// Vòng lặp bước cố định: ngủ tới tick kế tiếp hoặc phím bấm, giữ phần dư thời gian giữa các tick
+// Phím được đọc ở luồng riêng (InputThread) nên không phím nào bị lỡ khi đang vẽ hay đang ngủ
+void GameLoop() {
+    using clock = std::chrono::steady_clock;
+    auto last = clock::now();
+    double accMs = 0.0;
+
+    BeginPreciseTiming(); // Timer 1ms để Sleep/Wait thức dậy đúng hạn
+    frame.Invalidate(); // Màn hình đang là menu: lần đầu vẽ lại toàn bộ khung
+    RefreshScreen();
+    lastHud.clear();
+    DrawHud();
+    PROFILE_RESET();
+    input.Start();
+
+    while (state == 1) {
+        double moveInterval = MoveIntervalMs(game.speedLevel);
+
+        {
+            PROFILE_PHASE(PHASE_IDLE);
+            input.WaitForEvent(moveInterval - accMs);
+        }
+
+        auto now = clock::now();
+        accMs += std::chrono::duration<double, std::milli>(now - last).count();
+        last = now;
+
+        // Xử lý hết các phím đã bấm từ lần trước, theo đúng thứ tự
+        InputEvent ev;
+        PROFILE_PHASE(PHASE_INPUT);
+        while (state == 1 && input.Pop(ev)) {
+            // Mã mũi tên xuống (80) trùng 'P' nên phím mở rộng không được coi là phím lệnh
+            int key = ev.extended ? ev.key : std::toupper(ev.key);
+            bool paused = false;
+
+            if (!ev.extended && key == KEY_ESC) { state = 0; break; }
+            else if (!ev.extended && key == 'P') {
+                PrintBottom("Paused. Press any key to resume...");
+                {
+                    PROFILE_PHASE(PHASE_IDLE);
+                    input.WaitForEvent(-1);
+                }
+                input.Pop(ev);
+                PrintBottom("");
+                paused = true;
+            }
+            else if (!ev.extended && key == 'L') {
+                input.Pause(); // Trả stdin cho ReadWord
+                PrintBottom("Save as (filename.sav, .txt = text export): ");
+                string fn = ReadWord();
+                if (fn.empty()) PrintBottom("Save cancelled.");
+                else if (SaveToFile(fn)) PrintBottom("Saved to " + fn);
+                else PrintBottom("Save failed!");
+                input.Resume();
+                paused = true;
+            }
+            else if (!ev.extended && key == 'T') {
+                input.Pause();
+                PrintBottom("Load file: ");
+                string fn = ReadWord();
+                if (fn.empty()) PrintBottom("Load cancelled.");
+                else if (LoadFromFile(fn)) {
+                    RefreshScreen();
+                    PrintBottom("Loaded " + fn);
+                }
+                else PrintBottom("Load failed!");
+                input.Resume();
+                paused = true;
+            }
+            else {
+                // Phím điều hướng vào hàng lượt rẽ; phím trùng hướng hoặc quay đầu bị bỏ ngay
+                int newDir = GetDirectionFromKey(key);
+                if (newDir != -1 && !autopilot) turns.Push(newDir, game.moving);
+            }
+
+            if (paused) {
+                // Không tính thời gian tạm dừng/nhập tên file vào nhịp tick
+                last = clock::now();
+                accMs = 0.0;
+                lastHud.clear();
+                PROFILE_SKIP_TICK();
+            }
+        }
+        if (state != 1) break;
+
+        if (accMs >= moveInterval) {
+            // Kiểm tra rắn có hợp lệ không
+            if (game.snake.empty()) {
+                state = 0;
+                break;
+            }
+
+            PROFILE_TICK(moveInterval);
+            {
+                PROFILE_PHASE(PHASE_SIMULATE);
+                // Mỗi tick thực hiện một lượt rẽ đã xếp hàng, hoặc hướng bot chọn
+                int turn = autopilot ? pilot.NextDirection(game) : turns.Pop(game.moving, game.snake.size());
+                if (turn >= 0 && CanChangeDirection(turn, game.moving, game.snake.size())) game.moving = turn;
+
+                Step(game.moving);
+            }
+            if (state != 1) break;
+
+            // Dựng lại khung hình, chỉ các ô thay đổi được ghi ra console
+            PROFILE_PHASE(PHASE_RENDER);
+            ComposeFrame();
+            {
+                PROFILE_PHASE(PHASE_PRESENT);
+                PresentFrame(frame);
+            }
+
+            // Giữ phần dư để nhịp không bị trôi; bỏ phần tồn đọng sau hiệu ứng qua màn
+            accMs -= moveInterval;
+            if (accMs >= moveInterval) accMs = 0.0;
+            DrawHud();
+#ifdef SNAKE_PROFILE
+            // Dòng số đo dưới dòng thông báo, cập nhật mỗi giây
+            if (GlobalProfiler().OverlayDue(1000)) {
+                string line = GlobalProfiler().OverlayLine();
+                line.resize(120, ' ');
+                GotoXY(0, frame.height + 2);
+                WriteText(line);
+                FlushOutput();
+            }
+#endif
+        }
+    }
+
+    input.Stop(); // Trả bàn phím cho menu và lời nhắc chơi lại
+    EndPreciseTiming();
+    PROFILE_DUMP("profile.txt");
+}
+
+// Gửi một khung tin nhỏ tới máy chủ; khung vài byte nên coi như luôn gửi hết một lần
+static void SendToServer(int fd, int type, const uint8_t* payload, size_t size) {
+    vector<uint8_t> out;
+    AppendFrame(out, type, payload, size);
+    NetSend(fd, out.data(), out.size());
+}
+
+// Chơi trên máy chủ (tools/SnakeServer): máy chủ chạy ván, máy khách gửi phím hướng và vẽ lại
+// từ keyframe/delta. false nếu không kết nối được
+bool NetworkLoop(const string& host, int port) {
+    game.levels = &levelMaps;
+    int fd = NetConnect(host, port);
+    if (fd < 0) return false;
+    if (!NetSetNonBlocking(fd)) {
+        NetClose(fd);
+        return false;
+    }
+    vector<uint8_t> hello;
+    AppendHello(hello, autopilot ? NET_HELLO_AUTOPILOT : 0, levelHash);
+    NetSend(fd, hello.data(), hello.size());
+
+    using clock = std::chrono::steady_clock;
+    clock::time_point deadUntil;
+    vector<uint8_t> received;
+    bool synced = false, connected = true;
+    ClearScreen();
+    frame.Resize(0, 0); // Keyframe đầu tiên đặt kích thước khung chơi
+    lastHud.clear();
+    state = 1;
+    input.Start();
+
+    while (state == 1 && connected) {
+        input.WaitForEvent(10);
+
+        InputEvent ev;
+        while (input.Pop(ev)) {
+            int key = ev.extended ? ev.key : std::toupper(ev.key);
+            if (!ev.extended && key == KEY_ESC) { state = 0; break; }
+            int dir = GetDirectionFromKey(key);
+            if (dir != -1) {
+                uint8_t d = (uint8_t)dir;
+                SendToServer(fd, NET_INPUT, &d, 1);
+            }
+        }
+
+        uint8_t buf[4096];
+        long n;
+        while ((n = NetRecv(fd, buf, sizeof(buf))) > 0) received.insert(received.end(), buf, buf + n);
+        if (n < 0) connected = false;
+
+        bool redraw = false;
+        size_t pos = 0;
+        int type;
+        const uint8_t* payload;
+        size_t size;
+        while (NextFrame(received.data(), received.size(), pos, type, payload, size)) {
+            if (type == NET_KEYFRAME && ApplyKeyframe(game, payload, size, levelHash)) {
+                // Keyframe có thể là màn mới: khung chơi theo kích thước map
+                MapData& map = GetCurrentMap();
+                WIDTH_CONSOLE = map.width;
+                HEIGH_CONSOLE = map.height;
+                FitFrameToBoard();
+                frameStale = true;
+                synced = redraw = true;
+            }
+            else if (type == NET_DELTA && synced) {
+                bool dead = false;
+                if (!ApplyDelta(game, payload, size, dead)) {
+                    synced = false;
+                    SendToServer(fd, NET_RESYNC, nullptr, 0);
+                    continue;
+                }
+                redraw = true;
+                if (dead) {
+                    PrintBottom("Dead! Score: " + to_string(game.score) + ". The server starts a new game...");
+                    deadUntil = clock::now() + std::chrono::milliseconds(1500);
+                }
+            }
+        }
+        received.erase(received.begin(), received.begin() + pos);
+
+        if (redraw && synced) {
+            ComposeFrame();
+            PresentFrame(frame);
+            if (clock::now() >= deadUntil) DrawHud();
+            else lastHud.clear(); // Giữ thông báo chết, vẽ lại dòng trạng thái khi hết hạn
+        }
+    }
+
+    input.Stop();
+    NetClose(fd);
+    if (!connected) {
+        // Máy chủ ngắt ngay sau HELLO khi khác phiên bản hoặc khác bộ map (levels.pack)
+        PrintBottom(synced ? "Disconnected from server. Press any key..."
+            : "Server closed the connection (different version or level pack?). Press any key...");
+        GetKey();
+    }
+    return true;
+}
+
+// ===== MENU SYSTEM =====
+int Menu() {
+    ClearScreen();
+    DrawScreenBoard();
+    HideCursor();
+    PrintBottom("");
+    GotoXY(3, 3);  WriteText("HUNTING SNAKE");
+    GotoXY(3, 5);  WriteText("1) New Game");
+    GotoXY(3, 6);  WriteText("2) Load Game");
+    GotoXY(3, 7);  WriteText("3) High Scores");
+    GotoXY(3, 8);  WriteText("4) Settings");
+    GotoXY(3, 9);  WriteText("5) Quit");
+    GotoXY(3, 11); WriteText("Choose (1-5): ");
+    int ch = GetKey();
+    return ch;
+}
+
+void Settings() {
+    while (true) {
+        ClearScreen();
+        DrawScreenBoard();
+        DrawColoredText(3, 3, "SETTINGS", 14);
+        GotoXY(3, 5); WriteText(string("A) Keep length on level up: ") + (game.keepLengthWhenLevelUp ? "ON" : "OFF"));
+        GotoXY(3, 6); WriteText("B) Board Size (current " + to_string(WIDTH_CONSOLE) + "x" + to_string(HEIGH_CONSOLE) + ")");
+        GotoXY(3, 7); WriteText(string("C) Game Mode: ") + (game.mode == MODE_CLASSIC ? "Classic" :
+            game.mode == MODE_SURVIVAL ? "Survival" : "Time Attack"));
+        GotoXY(3, 8); WriteText(string("D) Autopilot: ") + (autopilot ? "ON" : "OFF"));
+        GotoXY(3, 9); WriteText("ESC) Back");
+
+        int k = GetKey();
+        if (k == KEY_ESC || k < 0) return;
+        k = std::toupper(k);
+        if (k == 'A') { game.keepLengthWhenLevelUp = !game.keepLengthWhenLevelUp; }
+        else if (k == 'B') {
+            PrintBottom("Enter WIDTH HEIGHT: ");
+            string w = ReadWord();
+            string h = w.empty() ? "" : ReadWord();
+            if (h.empty()) PrintBottom("Cancelled.");  // stdin đã đóng: giữ kích thước cũ
+            else {
+                WIDTH_CONSOLE = atoi(w.c_str());
+                HEIGH_CONSOLE = atoi(h.c_str());
+                PrintBottom("Applied.");
+            }
+        }
+        else if (k == 'C') {
+            int mode = game.mode;
+            mode = (mode + 1) % 3;
+            game.mode = mode;
+        }
+        else if (k == 'D') { autopilot = !autopilot; }
+    }
+}
+
+
+// Chơi tới khi thoát bằng ESC; sau khi chết hỏi chơi lại (Y)
+void PlayUntilQuit(bool newGame) {
+    while (true) {
+        if (newGame) ResetData();
+        newGame = true;
+        state = 1;
+        GameLoop();
+        if (recorder.active) {
+            // Chỉ ván bắt đầu từ seed mới phát lại được; ván nạp từ file không ghi replay
+            recorder.Finish(game);
+            SaveReplay(recorder.replay, REPLAY_FILE);
+        }
+        if (game.alive) return; // Thoát bằng ESC
+        if (std::toupper(GetKey()) != 'Y') return;
+    }
+}
+
+int main(int argc, char** argv) {
+    // --connect host:port: chơi trên máy chủ thay vì chạy ván tại chỗ; --autopilot: máy chủ tự lái
+    string server;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--connect" && i + 1 < argc) server = argv[++i];
+        else if (arg == "--autopilot") autopilot = true;
+    }
+
+    InitTerminal();
+    LoadLevelMaps();
+    LoadHighScore();
+    highScores.Open("highscores.txt");
+
+    if (!server.empty()) {
+        size_t colon = server.rfind(':');
+        string host = colon == string::npos ? server : server.substr(0, colon);
+        int port = colon == string::npos ? NET_DEFAULT_PORT : atoi(server.c_str() + colon + 1);
+        bool ok = NetworkLoop(host, port);
+        ClearScreen();
+        RestoreTerminal();
+        if (!ok) printf("Cannot connect to %s:%d\n", host.c_str(), port);
+        return ok ? 0 : 1;
+    }
+
+    while (true) {
+        int ch = Menu();
+        if (ch == '1') PlayUntilQuit(true);
+        else if (ch == '2') {
+            PrintBottom("Load file: ");
+            string fn = ReadWord();
+            if (fn.empty()) break;  // stdin đã đóng
+            if (LoadFromFile(fn)) PlayUntilQuit(false);
+            else { PrintBottom("Load failed! Press any key..."); GetKey(); }
+        }
+        else if (ch == '3') ShowHighScores();
+        else if (ch == '4') Settings();
+        else if (ch == '5' || ch == KEY_ESC || ch < 0) break;  // ch < 0: stdin đã đóng
+    }
+
+    SaveHighScore();
+    highScores.Close();  // Ghi chỉ mục bảng xếp hạng một lần khi thoát
+    ClearScreen();
+    RestoreTerminal();
+    return 0;
+}
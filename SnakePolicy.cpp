@@ -0,0 +1,95 @@
+// SnakePolicy.cpp — Các chính sách bot có sẵn
+
+#include "SnakePolicy.h"
+#include "Autopilot.h"
+#include "CyclePilot.h"
+#include <cstdlib>
+#include <memory>
+
+using namespace std;
+
+// Mục tiêu hiện tại: mồi đang hiện, nếu không thì cổng qua màn
+static bool FindTarget(const SnakeSim& sim, Point& target) {
+    if (sim.foodVisible && sim.foodIndex >= 0 && sim.foodIndex < (int)sim.foods.size()) {
+        target = sim.foods[sim.foodIndex];
+        return true;
+    }
+    if (sim.gateActive) {
+        target = sim.gatePos;
+        return true;
+    }
+    return false;
+}
+
+static bool SafeMove(const SnakeSim& sim, int dir) {
+    if (!CanChangeDirection(dir, sim.moving, sim.snake.size())) return false;
+    Point nh = sim.NextHead(dir);
+    return !sim.HitWall(nh) && !sim.HitSelf(nh);
+}
+
+// Đi thẳng mãi: mốc dưới cho thống kê
+static int StraightPolicy(const SnakeSim& sim) {
+    return sim.moving;
+}
+
+// Tiến gần mục tiêu nhất trong các hướng không chết ngay; hòa thì giữ hướng đang đi
+static int GreedyPolicy(const SnakeSim& sim) {
+    Point target;
+    bool hasTarget = FindTarget(sim, target);
+
+    int best = sim.moving;
+    int bestDist = -1;
+    for (int i = 0; i < 4; i++) {
+        int dir = (sim.moving + i) % 4; // Xét hướng hiện tại trước
+        if (!SafeMove(sim, dir)) continue;
+        Point nh = sim.NextHead(dir);
+        int dist = hasTarget ? abs(nh.x - target.x) + abs(nh.y - target.y) : 0;
+        if (bestDist < 0 || dist < bestDist) {
+            best = dir;
+            bestDist = dist;
+        }
+    }
+    return best;
+}
+
+SnakePolicy MakePolicy(const string& name, uint64_t seed) {
+    if (name == "straight") return StraightPolicy;
+    if (name == "greedy") return GreedyPolicy;
+    if (name == "random") {
+        // Hướng ngẫu nhiên trong các hướng an toàn, rng riêng của thể hiện
+        Pcg32 rng;
+        rng.Seed(seed);
+        return [rng](const SnakeSim& sim) mutable {
+            int safe[4], n = 0;
+            for (int dir = 0; dir < 4; dir++)
+                if (SafeMove(sim, dir)) safe[n++] = dir;
+            return n ? safe[rng.Below(n)] : sim.moving;
+        };
+    }
+    if (name == "autopilot") {
+        // std::function phải chép được: bộ đệm tìm đường giữ trong shared_ptr
+        auto pilot = make_shared<Autopilot>();
+        return [pilot](const SnakeSim& sim) { return pilot->NextDirection(sim); };
+    }
+    if (name == "cycle") {
+        auto pilot = make_shared<CyclePilot>();
+        return [pilot](const SnakeSim& sim) { return pilot->NextDirection(sim); };
+    }
+    return SnakePolicy();
+}
+
+int NextDirection(const SnakeSim& sim, const SnakePolicy& policy) {
+    int dir = policy(sim);
+    if (dir >= 0 && dir < 4 && dir != sim.moving && CanChangeDirection(dir, sim.moving, sim.snake.size()))
+        return dir;
+    return sim.moving;
+}
+
+int PlayGame(SnakeSim& sim, const SnakePolicy& policy, uint64_t maxTicks) {
+    int events = EVT_NONE;
+    while (sim.alive && sim.ticks < maxTicks) {
+        sim.moving = NextDirection(sim, policy);
+        events = sim.Step(sim.moving);
+    }
+    return events;
+}
@@ -0,0 +1,22 @@
+// SnakePolicy.h — Chính sách điều khiển rắn tự động (bot) và vòng chơi một ván không giao diện
+// Chính sách nhận trạng thái ván, trả về hướng cho bước kế tiếp (DIR_*)
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <cstdint>
+#include "SnakeSim.h"
+
+using SnakePolicy = std::function<int(const SnakeSim&)>;
+
+// Chính sách có sẵn theo tên: "straight", "random", "greedy", "autopilot" (BFS, Autopilot.h),
+// "cycle" (chu trình Hamilton, CyclePilot.h); hàm rỗng nếu không biết tên
+// Mỗi lời gọi tạo một thể hiện riêng (trạng thái riêng), dùng một thể hiện cho mỗi luồng
+SnakePolicy MakePolicy(const std::string& name, uint64_t seed);
+
+// Hướng cho bước kế tiếp: hướng chính sách chọn, giữ hướng cũ nếu không hợp lệ hoặc quay đầu 180 độ
+int NextDirection(const SnakeSim& sim, const SnakePolicy& policy);
+
+// Chơi ván đã Reset tới khi chết, đầy bàn hoặc đủ maxTicks bước; trả về cờ EVT_* của bước cuối
+int PlayGame(SnakeSim& sim, const SnakePolicy& policy, uint64_t maxTicks);
@@ -0,0 +1,219 @@
+// SnakeSave.cpp — Ghi/đọc snapshot nhị phân của SnakeSim
+
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include "SnakeSave.h"
+#include "MappedFile.h"
+#include "ByteIO.h"
+
+using namespace std;
+
+static const uint8_t SNAPSHOT_MAGIC[4] = { 'S', 'N', 'K', 'S' };
+static const uint8_t SNAKE_CHAIN = 0;  // Các đoạn liền kề: 2 bit hướng mỗi đoạn
+static const uint8_t SNAKE_RAW = 1;    // Đoạn không liền kề (file text cũ): u16 x, u16 y mỗi đoạn
+static const uint32_t MAX_SNAKE_LENGTH = 1u << 24;
+static const uint16_t MAX_FOODS = 1024;
+
+// ===== HELPERS =====
+static bool FitsU16(const Point& p) {
+    return p.x >= 0 && p.x <= 0xffff && p.y >= 0 && p.y <= 0xffff;
+}
+
+// Hướng từ a sang ô kề b, -1 nếu không kề
+static int StepDir(const Point& a, const Point& b) {
+    if (b.y == a.y && b.x == a.x - 1) return DIR_LEFT;
+    if (b.y == a.y && b.x == a.x + 1) return DIR_RIGHT;
+    if (b.x == a.x && b.y == a.y - 1) return DIR_UP;
+    if (b.x == a.x && b.y == a.y + 1) return DIR_DOWN;
+    return -1;
+}
+
+static Point Advance(Point p, int dir) {
+    if (dir == DIR_LEFT)  p.x--;
+    if (dir == DIR_RIGHT) p.x++;
+    if (dir == DIR_UP)    p.y--;
+    if (dir == DIR_DOWN)  p.y++;
+    return p;
+}
+
+// ===== ENCODE =====
+bool EncodeSnapshot(const SnakeSim& sim, vector<uint8_t>& out) {
+    const vector<MapData>& maps = sim.levels ? *sim.levels : DefaultLevelMaps();
+    const MapData& map = sim.CurrentMap();
+    if (sim.snake.empty() || sim.snake.size() > MAX_SNAKE_LENGTH || sim.foods.size() > MAX_FOODS) return false;
+
+    bool chain = true;
+    for (size_t i = 0; i < sim.snake.size(); i++) {
+        if (!FitsU16(sim.snake[i])) return false;
+        if (i > 0 && StepDir(sim.snake[i - 1], sim.snake[i]) < 0) chain = false;
+    }
+    for (auto& f : sim.foods) if (!FitsU16(f)) return false;
+
+    out.clear();
+    out.reserve(SNAPSHOT_HEADER_SIZE + 64 + sim.foods.size() * 4 + sim.snake.size() / 4 + 1);
+    ByteWriter w{ out };
+
+    // Header; payloadSize và checksum điền sau
+    for (uint8_t c : SNAPSHOT_MAGIC) w.U8(c);
+    w.U16(SNAPSHOT_VERSION);
+    w.U16((uint32_t)SNAPSHOT_HEADER_SIZE);
+    w.U32(0);
+    w.U32(0);
+
+    w.U8(sim.mode);
+    w.U8(sim.keepLengthWhenLevelUp);
+    w.U8((sim.alive ? 1 : 0) | (sim.gateActive ? 2 : 0) | (sim.foodVisible ? 4 : 0));
+    w.U8(sim.moving | (sim.locked << 2));
+    w.U32((uint32_t)sim.speedLevel);
+    w.U32((uint32_t)sim.score);
+    w.U32((uint32_t)sim.foodIndex);
+    w.U32((uint32_t)((sim.speedLevel - 1) % maps.size()));
+    w.U16((uint32_t)map.width);
+    w.U16((uint32_t)map.height);
+    w.U64(sim.rng.state);
+    w.U64(sim.ticks);
+    // Tọa độ u16 như mọi tọa độ khác; cổng đóng (cờ 2 ở trên) ghi 0xffff như các bản cũ ghi -1
+    w.U16(sim.gateActive ? (uint32_t)sim.gatePos.x : 0xffff);
+    w.U16(sim.gateActive ? (uint32_t)sim.gatePos.y : 0xffff);
+
+    w.U16((uint32_t)sim.foods.size());
+    for (auto& f : sim.foods) { w.U16(f.x); w.U16(f.y); }
+
+    w.U32((uint32_t)sim.snake.size());
+    w.U8(chain ? SNAKE_CHAIN : SNAKE_RAW);
+    w.U16(sim.snake.front().x);
+    w.U16(sim.snake.front().y);
+    if (chain) {
+        uint32_t bits = 0;
+        int used = 0;
+        for (size_t i = 1; i < sim.snake.size(); i++) {
+            bits |= (uint32_t)StepDir(sim.snake[i - 1], sim.snake[i]) << (2 * used);
+            if (++used == 4) { w.U8(bits); bits = 0; used = 0; }
+        }
+        if (used > 0) w.U8(bits);
+    }
+    else {
+        for (size_t i = 1; i < sim.snake.size(); i++) { w.U16(sim.snake[i].x); w.U16(sim.snake[i].y); }
+    }
+
+    size_t payloadSize = out.size() - SNAPSHOT_HEADER_SIZE;
+    w.Put32(8, (uint32_t)payloadSize);
+    w.Put32(12, Fnv1a(out.data() + SNAPSHOT_HEADER_SIZE, payloadSize));
+    return true;
+}
+
+// ===== DECODE =====
+bool IsSnapshot(const uint8_t* data, size_t size) {
+    if (size < sizeof(SNAPSHOT_MAGIC)) return false;
+    for (size_t i = 0; i < sizeof(SNAPSHOT_MAGIC); i++)
+        if (data[i] != SNAPSHOT_MAGIC[i]) return false;
+    return true;
+}
+
+bool DecodeSnapshot(SnakeSim& sim, const uint8_t* data, size_t size) {
+    if (size < SNAPSHOT_HEADER_SIZE || !IsSnapshot(data, size)) return false;
+
+    ByteReader h{ data + 4, data + SNAPSHOT_HEADER_SIZE };
+    uint32_t version = h.U16();
+    uint32_t headerSize = h.U16();
+    uint32_t payloadSize = h.U32();
+    uint32_t checksum = h.U32();
+    if (version != SNAPSHOT_VERSION || headerSize < SNAPSHOT_HEADER_SIZE || headerSize > size) return false;
+    if (payloadSize != size - headerSize) return false;
+    if (Fnv1a(data + headerSize, payloadSize) != checksum) return false;
+
+    // Giải mã vào bản sao để sim không bị sửa dở khi file hỏng
+    SnakeSim next;
+    next.levels = sim.levels;
+    const vector<MapData>& maps = next.levels ? *next.levels : DefaultLevelMaps();
+
+    ByteReader r{ data + headerSize, data + size };
+    next.mode = r.U8();
+    next.keepLengthWhenLevelUp = r.U8() != 0;
+    uint32_t flags = r.U8();
+    uint32_t dirs = r.U8();
+    next.alive = flags & 1;
+    next.gateActive = (flags & 2) != 0;
+    next.foodVisible = (flags & 4) != 0;
+    next.moving = dirs & 3;
+    next.locked = (dirs >> 2) & 3;
+    next.speedLevel = (int)r.U32();
+    next.score = (int)r.U32();
+    next.foodIndex = (int)r.U32();
+    uint32_t mapIndex = r.U32();
+    int mapWidth = (int)r.U16();
+    int mapHeight = (int)r.U16();
+    next.rng.state = r.U64();
+    next.ticks = r.U64();
+    next.gatePos.x = (int)r.U16();
+    next.gatePos.y = (int)r.U16();
+    if (!r.ok) return false;
+    if (!next.gateActive) next.gatePos = { -1, -1 };
+
+    if (next.mode < MODE_CLASSIC || next.mode > MODE_TIMEATTACK) return false;
+    if (next.speedLevel < 1 || next.speedLevel > MAX_SPEED || next.score < 0) return false;
+    // Bản đồ phải khớp bộ map đang dùng, nếu không tọa độ trong file vô nghĩa
+    if (mapIndex != (uint32_t)((next.speedLevel - 1) % maps.size())) return false;
+    const MapData& map = maps[mapIndex];
+    if (map.width != mapWidth || map.height != mapHeight) return false;
+    // Mọi tọa độ phải nằm trong vùng chơi: bot và bitboard đánh chỉ số theo ô không kiểm tra biên
+    auto inside = [&](const Point& q) { return q.x >= 1 && q.x < mapWidth && q.y >= 1 && q.y < mapHeight; };
+    if (next.gateActive && !inside(next.gatePos)) return false;
+
+    uint32_t foodCount = r.U16();
+    if (foodCount > MAX_FOODS || r.Left() < (size_t)foodCount * 4) return false;
+    next.foods.resize(foodCount);
+    for (auto& f : next.foods) {
+        f.x = (int)r.U16();
+        f.y = (int)r.U16();
+        if (!inside(f) || IsBlocked(map, f)) return false;
+    }
+    if (foodCount > 0 && (next.foodIndex < 0 || next.foodIndex >= (int)foodCount)) return false;
+
+    uint32_t len = r.U32();
+    uint32_t encoding = r.U8();
+    Point p;
+    p.x = (int)r.U16();
+    p.y = (int)r.U16();
+    if (!r.ok || len == 0 || len > MAX_SNAKE_LENGTH || !inside(p)) return false;
+
+    size_t bodyBytes = encoding == SNAKE_CHAIN ? (len - 1 + 3) / 4 : (size_t)(len - 1) * 4;
+    if (encoding > SNAKE_RAW || r.Left() != bodyBytes) return false;
+
+    // Giữ trước như SpawnSnake (bàn lớn chỉ một phần), không cấp phát theo diện tích bàn 65535 x 65535
+    next.snake.reserve(max((size_t)len, min((size_t)mapWidth * mapHeight, (size_t)DENSE_BOARD_CELLS)));
+    next.snake.push_back(p);
+    for (uint32_t i = 1; i < len; i++) {
+        if (encoding == SNAKE_CHAIN) {
+            uint32_t bits = r.p[(i - 1) / 4];
+            p = Advance(p, (bits >> (2 * ((i - 1) % 4))) & 3);
+        }
+        else {
+            p.x = (int)r.U16();
+            p.y = (int)r.U16();
+        }
+        if (!inside(p)) return false;
+        next.snake.push_back(p);
+    }
+
+    next.RebuildOccupancy();
+    sim = std::move(next);
+    return true;
+}
+
+// ===== FILES =====
+bool SaveSnapshot(const SnakeSim& sim, const string& path) {
+    vector<uint8_t> buf;
+    if (!EncodeSnapshot(sim, buf)) return false;
+    ofstream fo(path, ios::binary | ios::trunc);
+    if (!fo) return false;
+    fo.write((const char*)buf.data(), (streamsize)buf.size());
+    return (bool)fo;
+}
+
+bool LoadSnapshot(SnakeSim& sim, const string& path) {
+    MappedFile file;
+    if (!file.Open(path)) return false;
+    return DecodeSnapshot(sim, file.data, file.size);
+}
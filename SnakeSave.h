@@ -0,0 +1,29 @@
+// SnakeSave.h — File lưu ván chơi dạng nhị phân có phiên bản và checksum
+// Ghi bằng một lần write, đọc thẳng từ vùng nhớ ánh xạ (MappedFile) không qua iostream
+//
+// Bố cục (little-endian, không padding):
+//   Header 16 byte: "SNKS" | u16 version | u16 headerSize | u32 payloadSize | u32 FNV-1a(payload)
+//   Payload: cấu hình + trạng thái (điểm, level, map, mode, RNG, tick), cổng, mồi,
+//            rắn = tọa độ đuôi + 2 bit hướng cho mỗi đoạn tiếp theo (4 đoạn/byte)
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include "SnakeSim.h"
+
+const uint16_t SNAPSHOT_VERSION = 2; // 2: trạng thái PCG32 64 bit thay cho LCG 32 bit
+const size_t SNAPSHOT_HEADER_SIZE = 16;
+
+// Mã hóa toàn bộ trạng thái sim; trả về false nếu có tọa độ không biểu diễn được
+bool EncodeSnapshot(const SnakeSim& sim, std::vector<uint8_t>& out);
+// Giải mã và kiểm tra (header, checksum, giới hạn, khớp bản đồ của sim.levels)
+// Chỉ ghi vào sim khi mọi thứ hợp lệ; sim giữ nguyên nếu trả về false
+bool DecodeSnapshot(SnakeSim& sim, const uint8_t* data, size_t size);
+// Có phải file snapshot không (chỉ xem magic), dùng để chọn định dạng khi load
+bool IsSnapshot(const uint8_t* data, size_t size);
+
+bool SaveSnapshot(const SnakeSim& sim, const std::string& path);
+bool LoadSnapshot(SnakeSim& sim, const std::string& path);
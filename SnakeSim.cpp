@@ -0,0 +1,674 @@
+// SnakeSim.cpp — Cài đặt lõi mô phỏng Snake (luật chơi tách khỏi phần vẽ console)
+
+#include "SnakeSim.h"
+#include "Board.h"
+#include "ByteIO.h"
+#include <algorithm>
+
+using namespace std;
+
+// ===== MAP SYSTEM =====
+// Tạo các bản đồ cho từng level với độ khó tăng dần: tường đã dựng sẵn lúc biên dịch (BUILTIN_LEVELS)
+void InitializeLevelMaps(vector<MapData>& maps) {
+    maps.clear();
+    maps.reserve(BUILTIN_LEVEL_COUNT);
+    for (const BuiltinLevel& level : BUILTIN_LEVELS) {
+        MapData map;
+        map.width = ClassicBoard::WIDTH;
+        map.height = ClassicBoard::HEIGHT;
+        map.startPos = { 35, 10 }; // Giữa màn hình
+        map.spawns = { { 10, 5 } };  // Rắn xuất phát ở dòng 5, mọi map để trống dòng này
+        map.themeName = level.themeName;
+        map.backgroundColor = level.backgroundColor;
+        InitMapTiles(map);
+        // Duyệt theo từ 64 bit, bỏ qua từ không có tường
+        for (int w = 0; w < ClassicBoard::WORDS; w++) {
+            if (!level.board.walls[w]) continue;
+            for (int i = w * 64; i < w * 64 + 64 && i < ClassicBoard::CELLS; i++)
+                if ((level.board.walls[w] >> (i & 63)) & 1)
+                    map.tiles.Set(i % ClassicBoard::STRIDE, i / ClassicBoard::STRIDE, TILE_WALL);
+        }
+        // Tính trước một lần cho mỗi map, bot CyclePilot chỉ đọc lại khi chơi
+        BuildHamiltonCycle(map);
+        maps.push_back(std::move(map));
+    }
+}
+
+// ===== HAMILTONIAN CYCLE =====
+// Ô trống nằm trong vùng chơi (không phải viền, không phải tường)
+static bool FreeCell(const MapData& map, int x, int y) {
+    return x > 0 && x < map.width && y > 0 && y < map.height && !IsBlocked(map, { x, y });
+}
+
+// Đi theo các cạnh đã nối từ ô đầu tiên, ghi thứ tự; đúng khi đi qua đủ mọi ô trống rồi quay về
+static bool TraceCycle(MapData& map, const vector<uint8_t>& links, int start, int freeCount) {
+    static const int DX[4] = { -1, 1, 0, 0 }, DY[4] = { 0, 0, -1, 1 }; // Cùng thứ tự DIR_*
+    int w = map.width;
+    map.cycleOrder.assign((size_t)w * map.height, -1);
+    map.cycleCells.clear();
+    int cell = start, prev = -1;
+    do {
+        if (map.cycleOrder[cell] >= 0) break;
+        map.cycleOrder[cell] = (int)map.cycleCells.size();
+        map.cycleCells.push_back(cell);
+        int next = -1;
+        for (int d = 0; d < 4 && next < 0; d++) {
+            if (!(links[cell] & (1 << d))) continue;
+            int n = (cell / w + DY[d]) * w + cell % w + DX[d];
+            if (n != prev) next = n;
+        }
+        prev = cell;
+        cell = next;
+    } while (cell >= 0 && cell != start);
+
+    if (cell == start && (int)map.cycleCells.size() == freeCount) return true;
+    map.cycleCells.clear();
+    map.cycleOrder.clear();
+    return false;
+}
+
+// Ghép các khối 2x2: mỗi khối là một vòng 4 ô, cây khung nối các khối kề nhau; mỗi cạnh cây
+// bỏ hai cạnh song song của hai khối và nối chéo sang nhau, gộp hai vòng thành một
+static bool BuildBlockCycle(MapData& map, int ox, int oy, int freeCount) {
+    int w = map.width, h = map.height;
+    int bw = (w - 1 - ox) / 2, bh = (h - 1 - oy) / 2;  // Số khối theo mỗi chiều
+    if (bw <= 0 || bh <= 0) return false;
+    auto blockFree = [&](int bx, int by) {
+        int x = 1 + ox + 2 * bx, y = 1 + oy + 2 * by;
+        return FreeCell(map, x, y) && FreeCell(map, x + 1, y) && FreeCell(map, x, y + 1) && FreeCell(map, x + 1, y + 1);
+    };
+
+    // Mọi ô trống phải nằm trong một khối trống trọn vẹn
+    int blocks = 0;
+    for (int by = 0; by < bh; by++)
+        for (int bx = 0; bx < bw; bx++)
+            if (blockFree(bx, by)) blocks++;
+    if (blocks * 4 != freeCount) return false;
+
+    // Cạnh của chu trình: mỗi ô một mặt nạ 4 bit theo DIR_*
+    const uint8_t L = 1 << DIR_LEFT, R = 1 << DIR_RIGHT, U = 1 << DIR_UP, D = 1 << DIR_DOWN;
+    vector<uint8_t> links((size_t)w * h, 0);
+    auto at = [&](int bx, int by, int cx, int cy) -> uint8_t& {
+        return links[(size_t)(1 + oy + 2 * by + cy) * w + 1 + ox + 2 * bx + cx];
+    };
+    int firstX = -1, firstY = -1;
+    for (int by = 0; by < bh; by++)
+        for (int bx = 0; bx < bw; bx++) {
+            if (!blockFree(bx, by)) continue;
+            if (firstX < 0) { firstX = bx; firstY = by; }
+            at(bx, by, 0, 0) = R | D;
+            at(bx, by, 1, 0) = L | D;
+            at(bx, by, 0, 1) = U | R;
+            at(bx, by, 1, 1) = U | L;
+        }
+
+    // Cây khung BFS trên các khối
+    vector<uint8_t> inTree((size_t)bw * bh, 0);
+    vector<int> queue;
+    queue.reserve(blocks);
+    queue.push_back(firstY * bw + firstX);
+    inTree[queue[0]] = 1;
+    for (size_t qi = 0; qi < queue.size(); qi++) {
+        int bx = queue[qi] % bw, by = queue[qi] / bw;
+        const int nbx[4] = { bx - 1, bx + 1, bx, bx }, nby[4] = { by, by, by - 1, by + 1 };
+        for (int d = 0; d < 4; d++) {
+            int nx = nbx[d], ny = nby[d];
+            if (nx < 0 || nx >= bw || ny < 0 || ny >= bh || inTree[ny * bw + nx] || !blockFree(nx, ny)) continue;
+            inTree[ny * bw + nx] = 1;
+            queue.push_back(ny * bw + nx);
+            // a là khối bên trái/trên, b là khối bên phải/dưới
+            int ax = min(bx, nx), ay = min(by, ny), cx = max(bx, nx), cy = max(by, ny);
+            if (ay == cy) {
+                at(ax, ay, 1, 0) = (at(ax, ay, 1, 0) & ~D) | R;
+                at(ax, ay, 1, 1) = (at(ax, ay, 1, 1) & ~U) | R;
+                at(cx, cy, 0, 0) = (at(cx, cy, 0, 0) & ~D) | L;
+                at(cx, cy, 0, 1) = (at(cx, cy, 0, 1) & ~U) | L;
+            }
+            else {
+                at(ax, ay, 0, 1) = (at(ax, ay, 0, 1) & ~R) | D;
+                at(ax, ay, 1, 1) = (at(ax, ay, 1, 1) & ~L) | D;
+                at(cx, cy, 0, 0) = (at(cx, cy, 0, 0) & ~R) | U;
+                at(cx, cy, 1, 0) = (at(cx, cy, 1, 0) & ~L) | U;
+            }
+        }
+    }
+    if ((int)queue.size() != blocks) return false; // Các khối không liền nhau
+
+    return TraceCycle(map, links, (1 + oy + 2 * firstY) * w + 1 + ox + 2 * firstX, freeCount);
+}
+
+// Map không có tường trong, một cạnh vùng chơi chẵn: hàng đầu đi hết, các hàng sau zig-zag
+// từ cột 2, quay về theo cột 1 (như BuildCycle của benchmark); đổi trục nếu số hàng lẻ
+static bool BuildRectCycle(MapData& map, int freeCount) {
+    int cols = map.width - 1, rows = map.height - 1;
+    if (cols * rows != freeCount) return false;
+    bool transpose = rows % 2 != 0;
+    int a = transpose ? rows : cols, b = transpose ? cols : rows; // a theo hàng, b (chẵn) số hàng
+    if (b % 2 != 0 || a < 2) return false;
+
+    map.cycleCells.clear();
+    auto add = [&](int i, int j) {
+        int x = transpose ? j : i, y = transpose ? i : j;
+        map.cycleCells.push_back(y * map.width + x);
+    };
+    for (int i = 1; i <= a; i++) add(i, 1);
+    for (int j = 2; j <= b; j++) {
+        if (j % 2 == 0) for (int i = a; i >= 2; i--) add(i, j);
+        else for (int i = 2; i <= a; i++) add(i, j);
+    }
+    for (int j = b; j >= 2; j--) add(1, j);
+
+    map.cycleOrder.assign((size_t)map.width * map.height, -1);
+    for (size_t k = 0; k < map.cycleCells.size(); k++) map.cycleOrder[map.cycleCells[k]] = (int)k;
+    return true;
+}
+
+// Điều kiện cần của chu trình Hamilton trên lưới: ô trống liền một khối, mỗi ô có ít nhất hai ô trống kề,
+// và vì lưới là đồ thị hai phía (chu trình đi xen kẽ hai màu ô bàn cờ) số ô hai màu phải bằng nhau
+static bool CycleCanExist(const MapData& map, int freeCount) {
+    if (freeCount < 4) return false;
+    int w = map.width;
+    vector<uint8_t> seen((size_t)w * (map.height + 1), 0);  // Ô kề dưới hàng cuối vẫn nằm trong mảng
+    vector<int> stack;
+    int colorBalance = 0, reached = 0;
+    for (int y = 1; y < map.height; y++)
+        for (int x = 1; x < w; x++) {
+            if (!FreeCell(map, x, y)) continue;
+            colorBalance += (x + y) % 2 ? 1 : -1;
+            int degree = FreeCell(map, x - 1, y) + FreeCell(map, x + 1, y) + FreeCell(map, x, y - 1) + FreeCell(map, x, y + 1);
+            if (degree < 2) return false;
+            if (reached > 0) continue;
+            // Loang từ ô trống đầu tiên
+            stack.push_back(y * w + x);
+            seen[y * w + x] = 1;
+            while (!stack.empty()) {
+                int c = stack.back();
+                stack.pop_back();
+                reached++;
+                const int next[4] = { c - 1, c + 1, c - w, c + w };
+                for (int n : next)
+                    if (!seen[n] && FreeCell(map, n % w, n / w)) {
+                        seen[n] = 1;
+                        stack.push_back(n);
+                    }
+            }
+        }
+    return colorBalance == 0 && reached == freeCount;
+}
+
+int BuildHamiltonCycle(MapData& map) {
+    map.cycleCells.clear();
+    map.cycleOrder.clear();
+    // cycleOrder là mảng dày theo ô: bàn quá lớn thì không dựng, bot dùng BFS
+    if ((uint64_t)map.width * map.height > (uint64_t)DENSE_BOARD_CELLS) return CYCLE_TOO_LARGE;
+    int freeCount = 0;
+    for (int y = 1; y < map.height; y++)
+        for (int x = 1; x < map.width; x++)
+            if (FreeCell(map, x, y)) freeCount++;
+    if (!CycleCanExist(map, freeCount)) return CYCLE_IMPOSSIBLE;
+
+    for (int oy = 0; oy < 2; oy++)
+        for (int ox = 0; ox < 2; ox++)
+            if (BuildBlockCycle(map, ox, oy, freeCount)) return CYCLE_BUILT;
+    return BuildRectCycle(map, freeCount) ? CYCLE_BUILT : CYCLE_NOT_FOUND;
+}
+
+const char* CycleResultText(int result) {
+    switch (result) {
+    case CYCLE_BUILT: return "Hamiltonian cycle built";
+    case CYCLE_IMPOSSIBLE: return "no Hamiltonian cycle exists";
+    case CYCLE_NOT_FOUND: return "no Hamiltonian cycle found";
+    default: return "board too large for a Hamiltonian cycle";
+    }
+}
+
+// Ô tường vùng chơi theo thứ tự hàng rồi cột; bàn thưa chỉ đọc các khối đã cấp phát (duyệt theo hàng
+// khối, trong mỗi hàng ô lần lượt qua các khối) nên cho cùng dãy ô như bàn dày
+uint32_t LevelSetHash(const vector<MapData>& maps) {
+    vector<uint8_t> buf;
+    ByteWriter w{ buf };
+    uint32_t h = Fnv1a(nullptr, 0);
+    auto flush = [&] {
+        h = Fnv1a(buf.data(), buf.size(), h);
+        buf.clear();
+    };
+    w.U32((uint32_t)maps.size());
+    for (const MapData& map : maps) {
+        w.U16((uint32_t)map.width);
+        w.U16((uint32_t)map.height);
+        w.U16((uint32_t)map.spawns.size());
+        for (const Point& p : map.spawns) { w.U16((uint32_t)p.x); w.U16((uint32_t)p.y); }
+        auto wall = [&](int x, int y) {
+            w.U16((uint32_t)x);
+            w.U16((uint32_t)y);
+            if (buf.size() >= 4096) flush();
+        };
+        if ((uint64_t)map.width * map.height <= (uint64_t)DENSE_BOARD_CELLS) {
+            for (int y = 1; y < map.height; y++)
+                for (int x = 1; x < map.width; x++)
+                    if (IsBlocked(map, { x, y })) wall(x, y);
+        }
+        else {
+            const ChunkGrid<TileChunk>& chunks = map.tiles.Chunks();
+            for (int cy = 0; cy < chunks.ChunksY(); cy++) {
+                int y0 = max(cy << CHUNK_SHIFT, 1), y1 = min((cy + 1) << CHUNK_SHIFT, map.height);
+                for (int y = y0; y < y1; y++)
+                    for (int cx = 0; cx < chunks.ChunksX(); cx++) {
+                        const TileChunk* c = chunks.Find(cx, cy);
+                        if (!c) continue;
+                        int x0 = max(cx << CHUNK_SHIFT, 1), x1 = min((cx + 1) << CHUNK_SHIFT, map.width);
+                        for (int x = x0; x < x1; x++)
+                            if (c->cells[((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK)] != TILE_EMPTY) wall(x, y);
+                    }
+            }
+        }
+        w.U32(0xffffffffu);  // Hết map: bộ map khác nhau cách chia không trùng mã
+    }
+    flush();
+    return h;
+}
+
+// Bộ bản đồ mặc định, chỉ tạo một lần cho mọi ván mô phỏng
+const vector<MapData>& DefaultLevelMaps() {
+    static const vector<MapData> maps = [] {
+        vector<MapData> m;
+        InitializeLevelMaps(m);
+        return m;
+    }();
+    return maps;
+}
+
+void InitMapTiles(MapData& map) {
+    map.width = min(max(map.width, 0), MAX_BOARD_SIZE);
+    map.height = min(max(map.height, 0), MAX_BOARD_SIZE);
+    // Cùng ngưỡng với bitboard thân rắn: bàn lớn chỉ dùng khối thưa
+    bool dense = (uint64_t)map.width * map.height <= (uint64_t)DENSE_BOARD_CELLS;
+    map.tiles.Reset(map.width + 1, map.height + 1, TILE_EMPTY, dense);
+    for (int x = 0; x <= map.width; x++) {
+        map.tiles.Set(x, 0, TILE_BORDER);
+        map.tiles.Set(x, map.height, TILE_BORDER);
+    }
+    for (int y = 0; y <= map.height; y++) {
+        map.tiles.Set(0, y, TILE_BORDER);
+        map.tiles.Set(map.width, y, TILE_BORDER);
+    }
+}
+
+// ===== SAFE TILE ACCESS HELPERS =====
+// Kiểm tra vị trí có hợp lệ trong tiles array không
+bool IsValidTilePos(const MapData& map, int x, int y) {
+    return x >= 0 && x < map.width && y >= 0 && y < map.height &&
+        map.tiles.Width() == map.width + 1 && map.tiles.Height() == map.height + 1;
+}
+
+// Set tile an toàn (viền lính gác luôn giữ nguyên)
+void SetTile(MapData& map, int x, int y, char tile) {
+    if (IsValidTilePos(map, x, y) && x > 0 && y > 0) {
+        map.tiles.Set(x, y, tile);
+    }
+}
+
+// Get tile an toàn
+char GetTile(const MapData& map, int x, int y) {
+    if (IsValidTilePos(map, x, y)) {
+        return map.tiles.Get(x, y);
+    }
+    return ' '; // Trả về space nếu ngoài phạm vi
+}
+
+// ===== GAME UTILITIES =====
+// Kiểm tra xem hai hướng có ngược nhau không
+bool Opposite(int a, int b) {
+    return (a == DIR_LEFT && b == DIR_RIGHT) ||
+        (a == DIR_RIGHT && b == DIR_LEFT) ||
+        (a == DIR_UP && b == DIR_DOWN) ||
+        (a == DIR_DOWN && b == DIR_UP);
+}
+
+// Kiểm tra xem có thể thay đổi hướng di chuyển không (tránh đi ngược lại)
+bool CanChangeDirection(int newDir, int currentDir, size_t snakeLength) {
+    // Rắn quá ngắn (≤2 đoạn) thì có thể đi bất kỳ hướng nào
+    if (snakeLength <= 2) return true;
+
+    // Rắn dài thì không cho đi ngược lại hướng hiện tại
+    return !Opposite(newDir, currentDir);
+}
+
+double MoveIntervalMs(int speedLevel) {
+    const double baseMove = 220.0;
+    int lvl = min(max(speedLevel, 1), MAX_SPEED);
+    return baseMove / (1.0 + 0.4 * (lvl - 1));
+}
+
+// ===== SIMULATION =====
+int SnakeSim::RandIndex(int n) {
+    return (int)rng.Below((uint32_t)n);
+}
+
+const MapData& SnakeSim::CurrentMap() const {
+    const vector<MapData>& maps = levels ? *levels : DefaultLevelMaps();
+    int mapIndex = (speedLevel - 1) % maps.size(); // Lặp lại map khi hết
+    return maps[mapIndex];
+}
+
+// Tính toán vị trí đầu rắn mới theo hướng di chuyển (không thực sự di chuyển)
+Point SnakeSim::NextHead(int dir) const {
+    Point head = snake.back();
+    if (dir == DIR_LEFT)  head.x--;
+    if (dir == DIR_RIGHT) head.x++;
+    if (dir == DIR_UP)    head.y--;
+    if (dir == DIR_DOWN)  head.y++;
+    return head;
+}
+
+// Viền lính gác thay cho kiểm tra biên: một lần đọc mảng, không rẽ nhánh
+bool SnakeSim::HitWall(const Point& p) const {
+    return IsBlocked(*activeMap, p);
+}
+
+// ===== OCCUPANCY BITBOARD =====
+bool SnakeSim::IsOccupied(const Point& p) const {
+    if (p.x < 0 || p.x >= gridWidth || p.y < 0 || p.y >= gridHeight) return false;
+    return occupancy.Test(p.x, p.y);
+}
+
+void SnakeSim::SetOccupied(const Point& p, bool value) {
+    // Bỏ qua đoạn nằm ngoài map (rắn quá dài khi qua màn sẽ chết ngay bước sau)
+    if (p.x < 0 || p.x >= gridWidth || p.y < 0 || p.y >= gridHeight) return;
+    if (value) {
+        bool changed = occupancy.Set(p.x, p.y);
+        if (denseFree) freeCells.Erase(p.y * gridWidth + p.x);
+        else if (changed && !IsBlocked(*activeMap, p)) freeCount--;
+        SetBorderFree(p, false);
+    }
+    else {
+        bool changed = occupancy.Clear(p.x, p.y);
+        if (IsBlocked(*activeMap, p)) return; // Ô tường không bao giờ là ô trống
+        if (denseFree) freeCells.Insert(p.y * gridWidth + p.x);
+        else if (changed) freeCount++;
+        SetBorderFree(p, true);
+    }
+}
+
+void SnakeSim::SetBorderFree(const Point& p, bool free) {
+    if (p.y == 1)              free ? borderFree[0].Insert(p.x) : borderFree[0].Erase(p.x);
+    if (p.y == gridHeight - 1) free ? borderFree[1].Insert(p.x) : borderFree[1].Erase(p.x);
+    if (p.x == 1)              free ? borderFree[2].Insert(p.y) : borderFree[2].Erase(p.y);
+    if (p.x == gridWidth - 1)  free ? borderFree[3].Insert(p.y) : borderFree[3].Erase(p.y);
+}
+
+// Số ô tường trong vùng chơi: chỉ duyệt các khối tiles đã cấp phát (chỉ gọi cho bàn lớn)
+static uint64_t CountInnerWalls(const MapData& map) {
+    const ChunkGrid<TileChunk>& chunks = map.tiles.Chunks();
+    uint64_t walls = 0;
+    for (int cy = 0; cy < chunks.ChunksY(); cy++) {
+        for (int cx = 0; cx < chunks.ChunksX(); cx++) {
+            const TileChunk* c = chunks.Find(cx, cy);
+            if (!c) continue;
+            int x0 = max(cx << CHUNK_SHIFT, 1), x1 = min((cx + 1) << CHUNK_SHIFT, map.width);
+            int y0 = max(cy << CHUNK_SHIFT, 1), y1 = min((cy + 1) << CHUNK_SHIFT, map.height);
+            for (int y = y0; y < y1; y++)
+                for (int x = x0; x < x1; x++)
+                    if (c->cells[((y & CHUNK_MASK) << CHUNK_SHIFT) | (x & CHUNK_MASK)] != TILE_EMPTY) walls++;
+        }
+    }
+    return walls;
+}
+
+void SnakeSim::RebuildOccupancy() {
+    activeMap = &CurrentMap();
+    gridWidth = activeMap->width;
+    gridHeight = activeMap->height;
+
+    // Bàn nhỏ: bitboard liền và tập ô trống đầy đủ (chọn mồi O(1), giữ nguyên dãy mồi của replay cũ).
+    // Bàn lớn: bitboard chia khối, chỉ đếm ô trống, không duyệt từng ô của vùng chơi
+    denseFree = (uint64_t)gridWidth * gridHeight <= (uint64_t)DENSE_BOARD_CELLS;
+    occupancy.Reset(gridWidth, gridHeight, denseFree);
+    freeCells.Reset(denseFree ? gridWidth * gridHeight : 0);
+    freeCount = 0;
+    if (denseFree) {
+        for (int y = 1; y < gridHeight; y++)
+            for (int x = 1; x < gridWidth; x++)
+                if (!IsBlocked(*activeMap, { x, y })) freeCells.Insert(y * gridWidth + x);
+    }
+    else if (gridWidth > 1 && gridHeight > 1) {
+        freeCount = (uint64_t)(gridWidth - 1) * (gridHeight - 1) - CountInnerWalls(*activeMap);
+    }
+
+    // Mỗi cạnh theo thứ tự tọa độ tăng dần
+    borderFree[0].Reset(gridWidth);
+    borderFree[1].Reset(gridWidth);
+    borderFree[2].Reset(gridHeight);
+    borderFree[3].Reset(gridHeight);
+    for (int x = 1; x < gridWidth; x++) {
+        if (!IsBlocked(*activeMap, { x, 1 })) borderFree[0].Insert(x);
+        if (!IsBlocked(*activeMap, { x, gridHeight - 1 })) borderFree[1].Insert(x);
+    }
+    for (int y = 1; y < gridHeight; y++) {
+        if (!IsBlocked(*activeMap, { 1, y })) borderFree[2].Insert(y);
+        if (!IsBlocked(*activeMap, { gridWidth - 1, y })) borderFree[3].Insert(y);
+    }
+    for (auto& s : snake) SetOccupied(s, true);
+
+    headOffBoard = false;
+    if (!snake.empty()) {
+        const Point& head = snake.back();
+        headOffBoard = head.x <= 0 || head.x >= gridWidth || head.y <= 0 || head.y >= gridHeight;
+    }
+}
+
+bool SnakeSim::HitSelf(const Point& p) const {
+    // Kiểm tra va chạm với thân rắn (không kiểm tra đầu hiện tại)
+    if (snake.size() <= 1) return false;
+    return IsOccupied(p) && p != snake.back();
+}
+
+bool SnakeSim::Occupied(const Point& p) const {
+    if (IsOccupied(p)) return true;
+    return IsBlocked(*activeMap, p);
+}
+
+// Bàn lớn: chọn ngẫu nhiên trên vùng chơi, bỏ ô bận (gần như luôn trúng ngay vì phần lớn ô trống).
+// Trượt quá SPARSE_TRIES lần thì đếm ô trống theo từng khối 64x64 và chọn đều; vẫn đúng phân bố đều
+const int SPARSE_TRIES = 32;
+
+Point SnakeSim::RandomFreeCell() {
+    for (int i = 0; i < SPARSE_TRIES; i++) {
+        Point p{ RandIndex(gridWidth - 1) + 1, RandIndex(gridHeight - 1) + 1 };
+        if (!Occupied(p)) return p;
+    }
+
+    // freeCount < 2^32 vì cạnh tối đa MAX_BOARD_SIZE
+    uint64_t k = rng.Below((uint32_t)freeCount);
+    const ChunkGrid<TileChunk>& walls = activeMap->tiles.Chunks();
+    const ChunkGrid<BitChunk>& body = occupancy.Chunks();
+    for (int cy = 0; cy < body.ChunksY(); cy++) {
+        for (int cx = 0; cx < body.ChunksX(); cx++) {
+            int x0 = max(cx << CHUNK_SHIFT, 1), x1 = min((cx + 1) << CHUNK_SHIFT, gridWidth);
+            int y0 = max(cy << CHUNK_SHIFT, 1), y1 = min((cy + 1) << CHUNK_SHIFT, gridHeight);
+            if (x0 >= x1 || y0 >= y1) continue;
+            // Khối không có tường lẫn thân rắn: mọi ô đều trống, không cần duyệt
+            if (!walls.Find(cx, cy) && !body.Find(cx, cy)) {
+                uint64_t n = (uint64_t)(x1 - x0) * (y1 - y0);
+                if (k < n) return { x0 + (int)(k % (x1 - x0)), y0 + (int)(k / (x1 - x0)) };
+                k -= n;
+                continue;
+            }
+            for (int y = y0; y < y1; y++)
+                for (int x = x0; x < x1; x++)
+                    if (!Occupied({ x, y }) && k-- == 0) return { x, y };
+        }
+    }
+    return { 1, 1 }; // Không tới được khi freeCount đúng
+}
+
+// Lấy mẫu đều trong tập ô trống (cùng phân bố với cách chọn ngẫu nhiên rồi bỏ ô bận)
+bool SnakeSim::GenerateFoods() {
+    foods.clear();
+    if (FreeCellCount() == 0) return false;
+    while ((int)foods.size() < FOOD_COUNT) {
+        if (!denseFree) {
+            foods.push_back(RandomFreeCell());
+            continue;
+        }
+        int cell = freeCells.At(RandIndex(freeCells.Size()));
+        foods.push_back({ cell % gridWidth, cell / gridWidth });
+    }
+    foodIndex = 0;
+    foodVisible = true;
+    return true;
+}
+
+bool SnakeSim::SpawnGate() {
+    // Cách cũ chọn cạnh đều rồi chọn ô trên cạnh, bỏ ô bận; giữ đúng phân bố đó:
+    // xác suất chọn cạnh tỉ lệ với (số ô trống / độ dài cạnh), sau đó chọn đều trong cạnh
+    int edgeLen[4] = { gridWidth - 1, gridWidth - 1, gridHeight - 1, gridHeight - 1 };
+    double weight[4], total = 0;
+    for (int e = 0; e < 4; e++) {
+        weight[e] = (double)borderFree[e].Size() / edgeLen[e];
+        total += weight[e];
+    }
+    if (total <= 0) return false;
+
+    double r = rng.NextDouble() * total;
+    int edge = 0;
+    while (edge < 3 && (r >= weight[edge] || borderFree[edge].Empty())) {
+        r -= weight[edge];
+        edge++;
+    }
+    while (borderFree[edge].Empty()) edge--; // Sai số làm tròn ở cạnh cuối
+
+    int key = borderFree[edge].At(RandIndex(borderFree[edge].Size()));
+    if (edge == 0) gatePos = { key, 1 };
+    if (edge == 1) gatePos = { key, gridHeight - 1 };
+    if (edge == 2) gatePos = { 1, key };
+    if (edge == 3) gatePos = { gridWidth - 1, key };
+    gateActive = true;
+    foodVisible = false;
+    return true;
+}
+
+int SnakeSim::Eat() {
+    score += speedLevel * 10;
+    if (foodIndex == FOOD_COUNT - 1) {
+        return SpawnGate() ? EVT_GATE_OPEN : EVT_BOARD_FULL;
+    }
+    foodIndex++;
+    return EVT_NONE;
+}
+
+// Đặt rắn nằm ngang từ trái sang phải, đầu ở bên phải
+void SnakeSim::SpawnSnake(int len, int safeX, int safeY) {
+    const MapData& currentMap = CurrentMap();
+    // Không cấp phát lại khi đang chơi; bàn lớn chỉ giữ trước một phần, thân dài hơn thì tăng gấp đôi
+    snake.reserve(min((size_t)currentMap.width * currentMap.height, (size_t)DENSE_BOARD_CELLS));
+    snake.clear();
+    for (int i = 0; i < len; i++)
+        snake.push_back({ safeX + i, safeY });
+    RebuildOccupancy();
+}
+
+bool SnakeSim::LevelUp() {
+    score += speedLevel * 50;
+    gateActive = false;
+    gatePos = { -1,-1 };
+
+    if (speedLevel == MAX_SPEED) speedLevel = 1;
+    else speedLevel++;
+
+    // Giữ nguyên độ dài thực (tối thiểu 3) hoặc reset về 6 đoạn
+    int len = keepLengthWhenLevelUp ? max(3, (int)snake.size()) : 6;
+
+    const MapData& currentMap = CurrentMap();
+    int safeX = len + 2;  // Đảm bảo có đủ chỗ cho rắn dài
+    int safeY = currentMap.spawns.empty() ? 5 : currentMap.spawns[0].y;  // Dòng xuất phát của map
+    if (safeX + len >= currentMap.width) {
+        safeX = currentMap.width - len - 2;
+        if (safeX < 1) safeX = 1;
+    }
+    if (safeY >= currentMap.height) {
+        safeY = currentMap.height - 2;
+        if (safeY < 1) safeY = 1;
+    }
+    SpawnSnake(len, safeX, safeY);
+
+    // Reset hướng di chuyển về phải để tránh đụng thân ngay lập tức
+    moving = DIR_RIGHT;
+    locked = DIR_LEFT;
+
+    return GenerateFoods();
+}
+
+void SnakeSim::Reset(uint64_t seed) {
+    rng.Seed(seed);
+    alive = true;
+    ticks = 0;
+    moving = DIR_RIGHT;
+    locked = DIR_LEFT;
+    speedLevel = 1;
+    foodIndex = 0;
+    gateActive = false;
+    gatePos = { -1,-1 };
+    score = 0;
+
+    const MapData& currentMap = CurrentMap();
+    int initLen = 6;
+    int safeX = currentMap.spawns.empty() ? 10 : currentMap.spawns[0].x;
+    int safeY = currentMap.spawns.empty() ? 5 : currentMap.spawns[0].y;
+    if (safeX + initLen >= currentMap.width) {
+        safeX = currentMap.width - initLen - 2;
+    }
+    if (safeY >= currentMap.height) {
+        safeY = currentMap.height - 2;
+    }
+    SpawnSnake(initLen, safeX, safeY);
+
+    if (!GenerateFoods()) alive = false;
+}
+
+int SnakeSim::Step(int dir) {
+    if (!alive) return EVT_DEAD;
+    ticks++;
+
+    Point nh = NextHead(dir);
+    if (headOffBoard || HitWall(nh) || HitSelf(nh)) {
+        alive = false;
+        return EVT_DEAD;
+    }
+
+    bool eat = false;
+    if (foodIndex >= 0 && foodIndex < (int)foods.size() && foodVisible) {
+        eat = (nh == foods[foodIndex]);
+    }
+    bool hitGate = (gateActive && nh == gatePos);
+    return Advance(nh, dir, eat, hitGate);
+}
+
+int SnakeSim::Advance(const Point& nh, int dir, bool eat, bool hitGate) {
+    int events = EVT_MOVED;
+    snake.push_back(nh);
+    SetOccupied(nh, true);
+
+    if (eat) events |= EVT_EAT | Eat();
+    else {
+        // Xóa đuôi nếu không ăn mồi
+        SetOccupied(snake.front(), false);
+        snake.pop_front();
+    }
+
+    // Cập nhật hướng bị khóa chỉ khi rắn đủ dài
+    if (snake.size() > 2) {
+        if (dir == DIR_LEFT)  locked = DIR_RIGHT;
+        if (dir == DIR_RIGHT) locked = DIR_LEFT;
+        if (dir == DIR_UP)    locked = DIR_DOWN;
+        if (dir == DIR_DOWN)  locked = DIR_UP;
+    }
+    moving = dir;
+
+    if (hitGate) {
+        events |= EVT_LEVEL_UP;
+        if (!LevelUp()) events |= EVT_BOARD_FULL;
+    }
+    if (events & EVT_BOARD_FULL) alive = false;
+    return events;
+}
@@ -0,0 +1,185 @@
+// SnakeSim.h — Lõi mô phỏng Snake độc lập nền tảng (không I/O, không windows.h, không Sleep)
+// Dùng chung cho bản console, bot, replay và benchmark
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "RingBuffer.h"
+#include "CellSet.h"
+#include "ChunkGrid.h"
+#include "Random.h"
+
+// ===== CONSTANTS & ENUMS =====
+const int MAX_SPEED = 8;
+const int FOOD_COUNT = 4;
+const int MAX_BOARD_SIZE = 65535;         // Cạnh bàn chơi tối đa: tọa độ lưu u16 (SnakeSave, NetProtocol)
+const int DENSE_BOARD_CELLS = 1 << 20;    // Bàn chơi tới chừng này ô giữ tập ô trống dày (CellSet)
+
+// Direction constants (thay thế enum Direction)
+const int DIR_LEFT = 0;
+const int DIR_RIGHT = 1;
+const int DIR_UP = 2;
+const int DIR_DOWN = 3;
+
+// GameMode constants (thay thế enum GameMode)
+const int MODE_CLASSIC = 0;
+const int MODE_SURVIVAL = 1;
+const int MODE_TIMEATTACK = 2;
+
+// Cờ sự kiện trả về từ SnakeSim::Step (có thể kết hợp bằng |)
+const int EVT_NONE = 0;
+const int EVT_MOVED = 1;      // Rắn đã di chuyển một ô
+const int EVT_EAT = 2;        // Ăn mồi
+const int EVT_GATE_OPEN = 4;  // Cổng qua màn vừa xuất hiện
+const int EVT_LEVEL_UP = 8;   // Đi vào cổng, đã chuyển sang level mới
+const int EVT_DEAD = 16;      // Đâm tường hoặc tự cắn
+const int EVT_BOARD_FULL = 32; // Không còn ô trống để đặt mồi/cổng, ván kết thúc
+
+// ===== STRUCTS =====
+// Tọa độ ô trên bản đồ (không phụ thuộc POINT của windows.h)
+struct Point {
+    int x, y;
+};
+
+inline bool operator==(const Point& a, const Point& b) { return a.x == b.x && a.y == b.y; }
+inline bool operator!=(const Point& a, const Point& b) { return !(a == b); }
+
+// Ký hiệu ô trên bản đồ; mọi ô khác TILE_EMPTY đều chặn rắn
+const char TILE_EMPTY = ' ';
+const char TILE_WALL = '#';
+const char TILE_BORDER = 'X';  // Viền lính gác x = 0, x = width, y = 0, y = height
+
+struct MapData {
+    int width, height;
+    // (width + 1) x (height + 1) ô gồm cả viền lính gác, lưu theo khối 64x64: chỉ khối có tường
+    // hoặc viền được cấp phát
+    TileGrid tiles;
+    Point startPos;
+    std::vector<Point> spawns;  // Ô đuôi rắn lúc xuất phát (rắn nằm ngang sang phải); rỗng: (10, 5)
+    std::string themeName;
+    int backgroundColor;
+
+    // Chu trình Hamilton qua mọi ô trống (BuildHamiltonCycle), ô đánh số y * width + x như bitboard
+    // cycleCells[k] = ô thứ k trên chu trình, cycleOrder[ô] = k (-1: tường); rỗng nếu không có chu trình
+    std::vector<int> cycleCells;
+    std::vector<int> cycleOrder;
+
+    // Khóa ô dày y * (width + 1) + x cho các bộ máy giữ mảng riêng theo ô (Arena, MultiSim)
+    int Stride() const { return width + 1; }
+    int Index(int x, int y) const { return y * (width + 1) + x; }
+};
+
+// Dựng tiles theo width/height (tối đa MAX_BOARD_SIZE) với viền lính gác
+void InitMapTiles(MapData& map);
+
+// ===== SAFE TILE ACCESS HELPERS =====
+// Chỉ dùng khi tạo/vẽ bản đồ; vòng lặp game dùng IsBlocked
+bool IsValidTilePos(const MapData& map, int x, int y);
+void SetTile(MapData& map, int x, int y, char tile);
+char GetTile(const MapData& map, int x, int y);
+
+// Truy cập không kiểm tra: p phải nằm trong [0, width] x [0, height]
+// (luôn đúng với ô kề đầu rắn vì đầu rắn ở trong vùng chơi)
+inline bool IsBlocked(const MapData& map, const Point& p) {
+    return map.tiles.Get(p.x, p.y) != TILE_EMPTY;
+}
+
+// ===== MAP SYSTEM =====
+// Tạo 5 bản đồ mặc định cho từng level từ bitmap dựng lúc biên dịch (BUILTIN_LEVELS, Board.h),
+// kèm chu trình Hamilton nếu có
+void InitializeLevelMaps(std::vector<MapData>& maps);
+// Kết quả BuildHamiltonCycle
+const int CYCLE_BUILT = 0;       // cycleCells/cycleOrder đã có chu trình
+const int CYCLE_IMPOSSIBLE = 1;  // Chắc chắn không có: ô trống không liền, có ngõ cụt, hoặc hai màu ô (bàn cờ) lệch nhau
+const int CYCLE_NOT_FOUND = 2;   // Có thể có nhưng cách dựng theo khối 2x2 / hình chữ nhật không tìm ra
+const int CYCLE_TOO_LARGE = 3;   // Bàn lớn hơn DENSE_BOARD_CELLS: không dựng mảng theo ô
+// Tìm chu trình Hamilton qua các ô trống của map, lưu vào cycleCells/cycleOrder; trả về CYCLE_*
+int BuildHamiltonCycle(MapData& map);
+// Mô tả ngắn của kết quả CYCLE_* để công cụ in ra
+const char* CycleResultText(int result);
+// Bộ bản đồ mặc định dùng chung (tạo một lần)
+const std::vector<MapData>& DefaultLevelMaps();
+// Mã nhận diện bộ map theo phần ảnh hưởng tới ván (kích thước, ô xuất phát, tường), không theo tên/màu
+// hay nơi nạp: bộ dựng sẵn và levels.pack dịch từ maps/*.map chưa sửa cho cùng một mã. Replay và máy
+// chủ ghi mã này để không phát lại/đồng bộ trên bộ map khác
+uint32_t LevelSetHash(const std::vector<MapData>& maps);
+
+// ===== GAME UTILITIES =====
+bool Opposite(int a, int b);
+bool CanChangeDirection(int newDir, int currentDir, size_t snakeLength);
+// Thời gian giữa hai bước (ms) ở level speedLevel: 220ms, mỗi level nhanh thêm 40%, tối đa MAX_SPEED
+double MoveIntervalMs(int speedLevel);
+
+// ===== SIMULATION =====
+// Toàn bộ trạng thái một ván chơi, luật giống hệt bản console
+struct SnakeSim {
+    // Cấu hình
+    const std::vector<MapData>* levels = nullptr; // nullptr = DefaultLevelMaps()
+    bool keepLengthWhenLevelUp = true;
+    int mode = MODE_CLASSIC;
+
+    // Trạng thái
+    bool alive = false;
+    int moving = DIR_RIGHT;
+    int locked = DIR_LEFT;
+    int speedLevel = 1;
+    int score = 0;
+    RingBuffer<Point> snake;   // back() là đầu rắn, front() là đuôi
+    std::vector<Point> foods;
+    Point gatePos{ -1,-1 };
+    bool gateActive = false;
+    bool foodVisible = true;
+    int foodIndex = 0;
+    Pcg32 rng;                 // Bộ sinh ngẫu nhiên riêng của ván, Reset(seed) đặt lại
+    uint64_t ticks = 0;
+
+    // Bitboard các ô thân rắn (width*height bit của map hiện tại, theo khối 64x64), cập nhật theo từng bước
+    const MapData* activeMap = nullptr;
+    int gridWidth = 0, gridHeight = 0;
+    BitGrid occupancy;
+    bool headOffBoard = false;  // Rắn dài hơn map khi qua màn: đầu nằm ngoài, bước kế tiếp chắc chắn chết
+
+    // Ô trống (không tường, không thân rắn) để đặt mồi: khóa y*gridWidth + x. Chỉ dùng khi bàn chơi
+    // có tới DENSE_BOARD_CELLS ô; bàn lớn hơn chỉ đếm số ô trống và lấy mẫu trên lưới (RandomFreeCell)
+    bool denseFree = true;
+    CellSet freeCells;
+    uint64_t freeCount = 0;
+    // Ô trống trên 4 cạnh đặt cổng (hàng 1, hàng height-1, cột 1, cột width-1), khóa là x hoặc y
+    CellSet borderFree[4];
+
+    // Bắt đầu ván mới (giống ResetData của bản console); cùng seed + cùng dãy hướng = cùng ván
+    void Reset(uint64_t seed);
+    // Tiến một bước theo hướng dir, trả về các cờ EVT_*
+    int Step(int dir);
+    // Phần sau kiểm tra va chạm của Step (đã tăng ticks, nh không đâm tường/thân); eat và hitGate
+    // do người gọi tính sẵn. MultiSim kiểm tra va chạm cho nhiều ván một lúc rồi gọi hàm này
+    int Advance(const Point& nh, int dir, bool eat, bool hitGate);
+
+    const MapData& CurrentMap() const;
+    Point NextHead(int dir) const;
+    bool HitWall(const Point& p) const;
+    bool HitSelf(const Point& p) const;
+    bool Occupied(const Point& p) const;
+
+    // Dựng lại bitboard và tập ô trống sau khi sửa snake/level từ bên ngoài (load file, ...)
+    void RebuildOccupancy();
+    bool IsOccupied(const Point& p) const;
+
+    uint64_t FreeCellCount() const { return denseFree ? (uint64_t)freeCells.Size() : freeCount; }
+
+    // Trả về false nếu không còn ô trống (bàn chơi đầy)
+    bool GenerateFoods();
+    bool SpawnGate();
+    // Số ngẫu nhiên 0..n-1 từ rng của ván
+    int RandIndex(int n);
+
+private:
+    int Eat();
+    bool LevelUp();
+    void SpawnSnake(int len, int safeX, int safeY);
+    void SetOccupied(const Point& p, bool value);
+    Point RandomFreeCell();
+    void SetBorderFree(const Point& p, bool free);
+};
@@ -0,0 +1,41 @@
+// SpscQueue.h — Hàng đợi vòng không khóa một luồng ghi, một luồng đọc (single-producer single-consumer)
+// Sức chứa cố định, không cấp phát sau khi tạo; đầy thì push trả về false
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity phải là lũy thừa của 2");
+
+public:
+    // Chỉ gọi từ luồng ghi
+    bool push(const T& value) {
+        size_t tail = writePos.load(std::memory_order_relaxed);
+        if (tail - readPos.load(std::memory_order_acquire) == Capacity) return false;
+        slots[tail & (Capacity - 1)] = value;
+        writePos.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Chỉ gọi từ luồng đọc
+    bool pop(T& value) {
+        size_t head = readPos.load(std::memory_order_relaxed);
+        if (head == writePos.load(std::memory_order_acquire)) return false;
+        value = slots[head & (Capacity - 1)];
+        readPos.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return readPos.load(std::memory_order_acquire) == writePos.load(std::memory_order_acquire);
+    }
+
+private:
+    T slots[Capacity];
+    // Hai chỉ số nằm trên hai cache line khác nhau để hai luồng không tranh nhau một dòng cache
+    alignas(64) std::atomic<size_t> writePos{ 0 };
+    alignas(64) std::atomic<size_t> readPos{ 0 };
+};
@@ -0,0 +1,52 @@
+// Terminal.h — Lớp nền tảng cho bản console: vẽ, nhập phím, âm thanh, thời gian
+// TerminalWin32.cpp cài đặt bằng Win32 console API, TerminalVt.cpp bằng chuỗi escape VT
+// (Linux, macOS, SSH). Cả hai cùng giao diện nên SnakeConsole.cpp không cần #ifdef
+
+#pragma once
+
+#include <string>
+#include "FrameBuffer.h"
+
+// Mã phím mở rộng giống _getch(): phím mũi tên trả về KEY_EXTENDED rồi tới KEY_UP/...
+const int KEY_EXTENDED = 224;
+const int KEY_UP = 72;
+const int KEY_DOWN = 80;
+const int KEY_LEFT = 75;
+const int KEY_RIGHT = 77;
+const int KEY_ESC = 27;
+
+// ===== SETUP =====
+// Cố định cửa sổ, tắt Quick Edit / bật raw mode, ẩn con trỏ
+void InitTerminal();
+// Trả terminal về trạng thái ban đầu khi thoát
+void RestoreTerminal();
+
+// ===== OUTPUT =====
+void ClearScreen();
+void HideCursor(bool hide = true);
+void GotoXY(int x, int y);
+void SetColor(int color);            // Màu theo thuộc tính console Windows (0..15)
+void WriteText(const std::string& text);
+void FlushOutput();
+// Ghi các ô thay đổi của frame ra màn hình bằng một lần ghi
+void PresentFrame(FrameBuffer& frame);
+// Số cột/hàng đang thấy; false nếu không rõ (stdout không phải terminal)
+bool GetTerminalSize(int& width, int& height);
+
+// ===== INPUT =====
+bool KeyHit();
+int GetKey();                        // Chặn tới khi có phím
+bool WaitForKey(double timeoutMs);   // Ngủ tới khi có phím hoặc hết thời gian
+std::string ReadLine();              // Đọc một dòng có hiện chữ (tên file, tên người chơi)
+std::string ReadWord();              // Như cin >> s; rỗng nếu stdin đã đóng (coi như hủy)
+// Dành cho luồng nhập (InputThread): chờ tối đa timeoutMs, không đụng tới bộ đệm xuất
+bool PollKey(int timeoutMs, int& key);
+// Không còn phím nào tới nữa (stdin đóng): PollKey sẽ luôn trả về false ngay, không chờ
+bool InputClosed();
+
+// ===== SOUND & TIME =====
+void PlayTone(int frequency, int durationMs);
+void SleepMs(int ms);
+// Tăng độ phân giải timer trong lúc chơi (timeBeginPeriod trên Windows)
+void BeginPreciseTiming();
+void EndPreciseTiming();
@@ -0,0 +1,270 @@
+// TerminalVt.cpp — Cài đặt Terminal.h bằng chuỗi escape ANSI/VT cho Linux, macOS, SSH
+// Mọi thứ được gom vào một bộ đệm và gửi bằng một lần write() mỗi khung hình
+
+#ifndef _WIN32
+
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cmath>
+#include <ctime>
+#include <vector>
+#include "Terminal.h"
+
+using namespace std;
+
+static termios savedMode;
+static bool rawMode = false;
+static string outBuf;               // Dữ liệu chờ ghi ra stdout
+static vector<int> changedCells;    // Dùng lại giữa các khung hình, tránh cấp phát
+static int currentColor = -1;       // Màu terminal đang dùng, -1 = chưa rõ
+static int pendingKey = -1;         // Phím thứ hai của mã mở rộng (224, 72...)
+static atomic<bool> inputClosed{ false };  // Gặp EOF hoặc lỗi (stdin đóng, mất kết nối SSH); PollKey chạy ở luồng nhập
+
+// ===== OUTPUT (nội bộ) =====
+static void WriteAll(const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, data, len);
+        if (n <= 0) return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void AppendCursor(int x, int y) {
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\x1b[%d;%dH", y + 1, x + 1);
+    outBuf.append(seq, n);
+}
+
+// Thuộc tính console Windows: bit 0 xanh dương, bit 1 xanh lá, bit 2 đỏ, bit 3 sáng
+// ANSI: 1 đỏ, 2 xanh lá, 4 xanh dương; 30+n thường, 90+n sáng
+static void AppendColor(int color) {
+    if (color == currentColor) return;
+    currentColor = color;
+    int ansi = ((color & 4) ? 1 : 0) | ((color & 2) ? 2 : 0) | ((color & 1) ? 4 : 0);
+    int bg = (color >> 4) & 15;
+    int ansiBg = ((bg & 4) ? 1 : 0) | ((bg & 2) ? 2 : 0) | ((bg & 1) ? 4 : 0);
+    char seq[32];
+    int n = snprintf(seq, sizeof(seq), "\x1b[0;%d;%dm",
+        ((color & 8) ? 90 : 30) + ansi, ((bg & 8) ? 100 : 40) + ansiBg);
+    outBuf.append(seq, n);
+}
+
+// ===== SETUP =====
+static void EnterRawMode() {
+    if (rawMode || !isatty(STDIN_FILENO)) return;
+    termios raw = savedMode;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 1;
+    raw.c_cc[VTIME] = 0;
+    tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    rawMode = true;
+}
+
+static void LeaveRawMode() {
+    if (!rawMode) return;
+    tcsetattr(STDIN_FILENO, TCSANOW, &savedMode);
+    rawMode = false;
+}
+
+void InitTerminal() {
+    if (isatty(STDIN_FILENO)) tcgetattr(STDIN_FILENO, &savedMode);
+    EnterRawMode();
+    HideCursor();
+    FlushOutput();
+}
+
+void RestoreTerminal() {
+    outBuf += "\x1b[0m";
+    currentColor = -1;
+    HideCursor(false);
+    FlushOutput();
+    LeaveRawMode();
+}
+
+// ===== OUTPUT =====
+void ClearScreen() {
+    outBuf += "\x1b[0m\x1b[2J\x1b[H";
+    currentColor = -1;
+    FlushOutput();
+}
+
+void HideCursor(bool hide) {
+    outBuf += hide ? "\x1b[?25l" : "\x1b[?25h";
+}
+
+void GotoXY(int x, int y) {
+    AppendCursor(x, y);
+}
+
+void SetColor(int color) {
+    AppendColor(color);
+}
+
+void WriteText(const string& text) {
+    // Ở raw mode terminal không tự đổi '\n' thành xuống dòng về cột 0
+    for (char c : text) {
+        if (c == '\n') outBuf += "\r\n";
+        else outBuf += c;
+    }
+}
+
+void FlushOutput() {
+    if (outBuf.empty()) return;
+    WriteAll(outBuf.data(), outBuf.size());
+    outBuf.clear();
+}
+
+// Các ô liền nhau trên cùng hàng không cần dịch con trỏ; chỉ đổi màu khi màu khác
+void PresentFrame(FrameBuffer& frame) {
+    frame.CollectChanges(changedCells);
+    if (changedCells.empty()) return;
+
+    int cursor = -1;  // Chỉ số ô mà con trỏ terminal đang đứng
+    for (int i : changedCells) {
+        int x = i % frame.width, y = i / frame.width;
+        if (i != cursor || x == 0) AppendCursor(x, y);
+        const ScreenCell& c = frame.back[i];
+        AppendColor(c.color);
+        outBuf += c.ch ? c.ch : ' ';
+        cursor = i + 1;
+    }
+    FlushOutput();
+}
+
+bool GetTerminalSize(int& width, int& height) {
+    winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_col == 0 || ws.ws_row == 0) return false;
+    width = ws.ws_col;
+    height = ws.ws_row;
+    return true;
+}
+
+// ===== INPUT =====
+static bool InputReady(int timeoutMs) {
+    pollfd p{ STDIN_FILENO, POLLIN, 0 };
+    if (poll(&p, 1, timeoutMs) <= 0) return false;
+    // Đầu ghi đã đóng và không còn byte nào: mọi lần poll sau đều trả về ngay
+    if (!(p.revents & POLLIN) && (p.revents & (POLLHUP | POLLERR | POLLNVAL))) inputClosed = true;
+    return (p.revents & POLLIN) != 0;
+}
+
+static int ReadByte() {
+    unsigned char c;
+    ssize_t n;
+    do n = read(STDIN_FILENO, &c, 1); while (n < 0 && errno == EINTR);
+    return n == 1 ? c : -1;
+}
+
+bool KeyHit() {
+    return pendingKey >= 0 || InputReady(0);
+}
+
+// Đổi ESC [ A/B/C/D thành 224 + mã _getch để phần game dùng chung một bảng phím
+static int ReadKey() {
+    if (pendingKey >= 0) {
+        int k = pendingKey;
+        pendingKey = -1;
+        return k;
+    }
+
+    int c = ReadByte();
+    if (c != KEY_ESC) return c == '\n' ? '\r' : c;
+
+    // ESC đứng một mình (phím Esc) không có byte nào theo sau trong thời gian ngắn
+    if (!InputReady(30)) return KEY_ESC;
+    int c2 = ReadByte();
+    if (c2 != '[' && c2 != 'O') return KEY_ESC;
+    int c3 = ReadByte();
+    switch (c3) {
+    case 'A': pendingKey = KEY_UP; break;
+    case 'B': pendingKey = KEY_DOWN; break;
+    case 'C': pendingKey = KEY_RIGHT; break;
+    case 'D': pendingKey = KEY_LEFT; break;
+    default:
+        // Bỏ phần còn lại của chuỗi escape lạ (Home, F1, ...)
+        while (c3 >= 0 && !(c3 >= 0x40 && c3 <= 0x7e) && InputReady(0)) c3 = ReadByte();
+        return KEY_ESC;
+    }
+    return KEY_EXTENDED;
+}
+
+int GetKey() {
+    FlushOutput();
+    return ReadKey();
+}
+
+bool PollKey(int timeoutMs, int& key) {
+    if (pendingKey < 0 && !InputReady(timeoutMs)) return false;
+    key = ReadKey();
+    if (key < 0) inputClosed = true;
+    return key >= 0;
+}
+
+bool InputClosed() {
+    return inputClosed;
+}
+
+bool WaitForKey(double timeoutMs) {
+    FlushOutput();
+    if (pendingKey >= 0) return true;
+    if (timeoutMs <= 0) return InputReady(0);
+    return InputReady((int)ceil(timeoutMs));
+}
+
+// Tạm về canonical mode có echo để người chơi sửa được dòng đang gõ
+string ReadLine() {
+    HideCursor(false);
+    FlushOutput();
+    bool wasRaw = rawMode;
+    LeaveRawMode();
+
+    string line;
+    int c;
+    while ((c = ReadByte()) >= 0 && c != '\n') line += (char)c;
+    inputClosed = c < 0;
+
+    if (wasRaw) EnterRawMode();
+    HideCursor();
+    FlushOutput();
+    return line;
+}
+
+// Chuỗi rỗng nếu stdin đã đóng: người gọi coi như hủy thay vì chờ mãi
+string ReadWord() {
+    string word;
+    do {
+        string line = ReadLine();
+        size_t b = line.find_first_not_of(" \t");
+        if (b == string::npos) continue;
+        size_t e = line.find_first_of(" \t", b);
+        word = line.substr(b, e == string::npos ? string::npos : e - b);
+    } while (word.empty() && !inputClosed);
+    return word;
+}
+
+// ===== SOUND & TIME =====
+// Terminal không phát được tần số tùy ý: dùng chuông, thời lượng giữ nguyên để nhịp game không đổi
+void PlayTone(int frequency, int durationMs) {
+    (void)frequency;
+    outBuf += '\a';
+    SleepMs(durationMs);
+}
+
+void SleepMs(int ms) {
+    FlushOutput();
+    if (ms <= 0) return;
+    timespec ts{ ms / 1000, (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, nullptr);
+}
+
+// poll()/nanosleep đã có độ phân giải mili giây
+void BeginPreciseTiming() {}
+void EndPreciseTiming() {}
+
+#endif // !_WIN32
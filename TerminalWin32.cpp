@@ -0,0 +1,207 @@
+// TerminalWin32.cpp — Cài đặt Terminal.h bằng Win32 console API
+
+#ifdef _WIN32
+
+#define NOMINMAX
+#include <windows.h>
+#include <conio.h>
+#include <mmsystem.h>
+#include <atomic>
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "Terminal.h"
+#pragma comment(lib, "winmm.lib")
+
+using namespace std;
+
+static vector<int> changedCells;    // Dùng lại giữa các khung hình, tránh cấp phát
+static vector<CHAR_INFO> frameChars;
+static atomic<bool> inputClosed{ false };  // Input handle hỏng (console đã đóng), PollKey chạy ở luồng nhập
+
+// ===== SETUP =====
+// Cố định kích thước cửa sổ console, không cho phép thay đổi kích thước
+static void FixConsoleWindow() {
+    HWND wnd = GetConsoleWindow();
+    LONG style = GetWindowLong(wnd, GWL_STYLE);
+    style &= ~(WS_MAXIMIZEBOX) & ~(WS_THICKFRAME);
+    SetWindowLong(wnd, GWL_STYLE, style);
+}
+
+// Tắt chế độ Quick Edit để tránh game bị pause khi click chuột
+static void DisableQuickEdit() {
+    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
+    DWORD mode = 0;
+    GetConsoleMode(hIn, &mode);
+    mode &= ~ENABLE_QUICK_EDIT_MODE;
+    SetConsoleMode(hIn, mode);
+}
+
+void InitTerminal() {
+    FixConsoleWindow();
+    DisableQuickEdit();
+    HideCursor();
+}
+
+void RestoreTerminal() {
+    SetColor(7);
+    HideCursor(false);
+}
+
+// ===== OUTPUT =====
+void ClearScreen() {
+    cout.flush();
+    system("cls");
+}
+
+// Ẩn hoặc hiển thị con trỏ chuột trong console
+void HideCursor(bool hide) {
+    HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
+    CONSOLE_CURSOR_INFO info{ 25, !hide };
+    SetConsoleCursorInfo(h, &info);
+}
+
+// Di chuyển con trỏ console đến vị trí (x, y) để vẽ
+void GotoXY(int x, int y) {
+    cout.flush();
+    COORD c; c.X = (SHORT)x; c.Y = (SHORT)y;
+    SetConsoleCursorPosition(GetStdHandle(STD_OUTPUT_HANDLE), c);
+}
+
+// Đổi màu chữ trong console
+void SetColor(int color) {
+    cout.flush();
+    HANDLE h = GetStdHandle(STD_OUTPUT_HANDLE);
+    SetConsoleTextAttribute(h, color);
+}
+
+void WriteText(const string& text) {
+    cout << text;
+}
+
+void FlushOutput() {
+    cout.flush();
+}
+
+// Ghi vùng bao quanh các ô thay đổi bằng một lần WriteConsoleOutput
+// (thường chỉ là đầu mới, đuôi cũ và mồi, không phụ thuộc độ dài rắn)
+void PresentFrame(FrameBuffer& frame) {
+    frame.CollectChanges(changedCells);
+    if (changedCells.empty()) return;
+
+    int x0 = frame.width, y0 = frame.height, x1 = -1, y1 = -1;
+    for (int i : changedCells) {
+        int x = i % frame.width, y = i / frame.width;
+        x0 = min(x0, x); x1 = max(x1, x);
+        y0 = min(y0, y); y1 = max(y1, y);
+    }
+
+    int w = x1 - x0 + 1, h = y1 - y0 + 1;
+    frameChars.resize((size_t)w * h);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            const ScreenCell& c = frame.back[(size_t)(y0 + y) * frame.width + (x0 + x)];
+            CHAR_INFO& ci = frameChars[(size_t)y * w + x];
+            ci.Char.AsciiChar = c.ch;
+            ci.Attributes = c.color;
+        }
+    }
+    COORD size{ (SHORT)w, (SHORT)h };
+    SMALL_RECT region{ (SHORT)x0, (SHORT)y0, (SHORT)x1, (SHORT)y1 };
+    WriteConsoleOutputA(GetStdHandle(STD_OUTPUT_HANDLE), frameChars.data(), size, COORD{ 0, 0 }, &region);
+}
+
+// Kích thước cửa sổ (srWindow), không phải bộ đệm màn hình có thể dài hơn nhiều
+bool GetTerminalSize(int& width, int& height) {
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (!GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) return false;
+    width = info.srWindow.Right - info.srWindow.Left + 1;
+    height = info.srWindow.Bottom - info.srWindow.Top + 1;
+    return width > 0 && height > 0;
+}
+
+// ===== INPUT =====
+// Bỏ các sự kiện mà _getch không trả về (chuột, nhả phím, focus, Shift/Ctrl đứng một mình) để lần chờ sau
+// không bị đánh thức ngay. _kbhit false nghĩa là không sự kiện nào trong hàng là phím, nên bỏ sự kiện đầu
+// hàng (đã có từ trước lần kiểm tra) là an toàn; phím tới trong lúc đó nằm ở cuối hàng và không bị mất
+static void DropNonKeyEvents(HANDLE hIn) {
+    INPUT_RECORD rec;
+    DWORD n = 0;
+    while (!_kbhit() && GetNumberOfConsoleInputEvents(hIn, &n) && n > 0) ReadConsoleInputA(hIn, &rec, 1, &n);
+}
+
+bool KeyHit() {
+    return _kbhit() != 0;
+}
+
+int GetKey() {
+    cout.flush();
+    return _getch();
+}
+
+// Chờ trên input handle thay vì quay vòng Sleep(1)
+bool WaitForKey(double timeoutMs) {
+    if (_kbhit()) return true;
+    if (timeoutMs <= 0) return false;
+
+    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
+    if (WaitForSingleObject(hIn, (DWORD)ceil(timeoutMs)) != WAIT_OBJECT_0) return false;
+    if (_kbhit()) return true;
+
+    DropNonKeyEvents(hIn);
+    return _kbhit() != 0;
+}
+
+bool PollKey(int timeoutMs, int& key) {
+    if (!_kbhit()) {
+        HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
+        DWORD wait = WaitForSingleObject(hIn, (DWORD)timeoutMs);
+        if (wait == WAIT_FAILED) inputClosed = true;
+        if (wait != WAIT_OBJECT_0) return false;
+        if (!_kbhit()) {
+            DropNonKeyEvents(hIn);
+            if (!_kbhit()) return false;
+        }
+    }
+    key = _getch();
+    return true;
+}
+
+bool InputClosed() {
+    return inputClosed;
+}
+
+string ReadLine() {
+    cout.flush();
+    string line;
+    getline(cin, line);
+    return line;
+}
+
+string ReadWord() {
+    cout.flush();
+    string word;
+    cin >> word;
+    return word;
+}
+
+// ===== SOUND & TIME =====
+void PlayTone(int frequency, int durationMs) {
+    Beep(frequency, durationMs);
+}
+
+void SleepMs(int ms) {
+    cout.flush();
+    Sleep(ms);
+}
+
+void BeginPreciseTiming() {
+    timeBeginPeriod(1);
+}
+
+void EndPreciseTiming() {
+    timeEndPeriod(1);
+}
+
+#endif // _WIN32
@@ -0,0 +1,34 @@
+// TurnBuffer.h — Hàng đợi lượt rẽ: giữ các phím hướng bấm nhanh hơn nhịp tick
+// Mỗi tick lấy ra đúng một lượt rẽ hợp lệ, nên "lên rồi trái" trong cùng một tick không bị mất
+
+#pragma once
+
+#include <cstddef>
+#include "SnakeSim.h"
+
+struct TurnBuffer {
+    static const int CAPACITY = 4;  // Đủ cho chuỗi rẽ nhanh nhất của người chơi, bỏ phím thừa khi giữ phím
+    int turns[CAPACITY];
+    int count = 0;
+
+    void Clear() { count = 0; }
+
+    // So với hướng sẽ đi sau khi các lượt đã xếp hàng được thực hiện:
+    // bỏ phím trùng hướng hoặc quay ngược 180 độ, bỏ khi hàng đầy
+    void Push(int dir, int currentDir) {
+        int last = count > 0 ? turns[count - 1] : currentDir;
+        if (dir == last || Opposite(dir, last) || count == CAPACITY) return;
+        turns[count++] = dir;
+    }
+
+    // Lượt rẽ cho tick này, -1 nếu không có lượt hợp lệ
+    int Pop(int currentDir, size_t snakeLength) {
+        while (count > 0) {
+            int dir = turns[0];
+            for (int i = 1; i < count; i++) turns[i - 1] = turns[i];
+            count--;
+            if (dir != currentDir && CanChangeDirection(dir, currentDir, snakeLength)) return dir;
+        }
+        return -1;
+    }
+};
@@ -0,0 +1,67 @@
+// WorkStealingPool.h — Chia một dải việc [0, count) cho nhiều luồng theo kiểu work-stealing
+//
+// Dải việc được cắt thành các khúc (chunk) và chia đều vào hàng đợi riêng của mỗi luồng.
+// Mỗi luồng lấy việc ở cuối hàng của mình; hết việc thì lấy trộm khúc ở đầu hàng của luồng khác,
+// nên ván dài (rắn sống lâu) ở một luồng không làm các luồng còn lại ngồi chờ.
+// Không có việc mới sinh ra trong lúc chạy: một vòng quét không thấy khúc nào nghĩa là đã xong.
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// body(worker, begin, end) chạy trên luồng worker (0..threads-1) cho các việc begin..end-1
+inline void ParallelFor(size_t count, size_t chunk, int threads,
+    const std::function<void(int, size_t, size_t)>& body) {
+    if (count == 0) return;
+    if (chunk == 0) chunk = 1;
+    if (threads < 1) threads = 1;
+
+    struct Range { size_t begin, end; };
+    // Mỗi hàng đợi một cache line riêng; khóa chỉ bị tranh khi có luồng đến lấy trộm
+    struct alignas(64) WorkQueue {
+        std::mutex lock;
+        std::deque<Range> ranges;
+    };
+    std::vector<WorkQueue> queues(threads);
+
+    size_t chunks = (count + chunk - 1) / chunk;
+    for (size_t c = 0; c < chunks; c++) {
+        size_t begin = c * chunk;
+        size_t end = begin + chunk < count ? begin + chunk : count;
+        // Khúc liền nhau vào cùng một luồng: luồng đi từ cuối hàng, kẻ trộm lấy từ đầu hàng
+        queues[c * threads / chunks].ranges.push_back({ begin, end });
+    }
+
+    auto popOwn = [&](int w, Range& r) {
+        std::lock_guard<std::mutex> guard(queues[w].lock);
+        if (queues[w].ranges.empty()) return false;
+        r = queues[w].ranges.back();
+        queues[w].ranges.pop_back();
+        return true;
+    };
+    auto steal = [&](int w, Range& r) {
+        for (int i = 1; i < threads; i++) {
+            WorkQueue& victim = queues[(w + i) % threads];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (victim.ranges.empty()) continue;
+            r = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+        return false;
+    };
+    auto worker = [&](int w) {
+        Range r;
+        while (popOwn(w, r) || steal(w, r)) body(w, r.begin, r.end);
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < threads; w++) pool.emplace_back(worker, w);
+    worker(0); // Luồng gọi cũng làm việc
+    for (std::thread& t : pool) t.join();
+}
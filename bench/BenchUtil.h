@@ -0,0 +1,46 @@
+// BenchUtil.h — Hàm dùng chung cho các benchmark: bàn chơi trống và chu trình đi qua mọi ô
+
+#pragma once
+
+#include "SnakeSim.h"
+#include <vector>
+
+// Bàn chơi không có chướng ngại vật
+inline MapData MakeOpenBoard(int width, int height) {
+    MapData board;
+    board.width = width; board.height = height;
+    board.startPos = { width / 2, height / 2 };
+    board.themeName = "Bench";
+    board.backgroundColor = 7;
+    InitMapTiles(board);
+    return board;
+}
+
+// Chu trình đi qua mọi ô của vùng chơi cols x rows (rows chẵn): hàng 1 sang phải,
+// các hàng sau zig-zag ở cột 2..cols, quay về theo cột 1
+inline std::vector<Point> BuildCycle(int cols, int rows) {
+    std::vector<Point> cycle;
+    for (int x = 1; x <= cols; x++) cycle.push_back({ x, 1 });
+    for (int y = 2; y <= rows; y++) {
+        if (y % 2 == 0) for (int x = cols; x >= 2; x--) cycle.push_back({ x, y });
+        else for (int x = 2; x <= cols; x++) cycle.push_back({ x, y });
+    }
+    for (int y = rows; y >= 2; y--) cycle.push_back({ 1, y });
+    return cycle;
+}
+
+inline int DirTo(const Point& from, const Point& to) {
+    if (to.x < from.x) return DIR_LEFT;
+    if (to.x > from.x) return DIR_RIGHT;
+    if (to.y < from.y) return DIR_UP;
+    return DIR_DOWN;
+}
+
+// Đặt rắn dài len đoạn dọc theo chu trình (đuôi ở cycle[0]), tắt mồi và cổng
+inline void PlaceSnakeOnCycle(SnakeSim& sim, const std::vector<Point>& cycle, size_t len) {
+    sim.snake.clear();
+    for (size_t i = 0; i < len; i++) sim.snake.push_back(cycle[i]);
+    sim.RebuildOccupancy();
+    sim.foodVisible = false;
+    sim.gateActive = false;
+}
@@ -0,0 +1,81 @@
+// BodyBench.cpp — Đo chi phí mỗi bước của thân rắn khi độ dài tăng lên hàng nghìn đoạn
+// So sánh vector + erase(begin()) (cách cũ) với RingBuffer, và đo SnakeSim::Step trên map lớn
+//
+// Build: g++ -O2 -std=c++17 -I.. BodyBench.cpp ../SnakeSim.cpp -o BodyBench
+
+#include "BenchUtil.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+const int BOARD_W = 130;   // Vùng chơi x = 1..129
+const int BOARD_H = 65;    // Vùng chơi y = 1..64 (số hàng chẵn nên có chu trình đi qua mọi ô)
+const long long TICKS = 2000000;
+
+// Cách cũ: thêm đầu vào cuối vector và xóa đuôi ở đầu vector
+double BenchVectorBody(const vector<Point>& cycle, size_t len) {
+    vector<Point> body(cycle.begin(), cycle.begin() + len);
+    size_t next = len;
+    auto t0 = Clock::now();
+    for (long long i = 0; i < TICKS; i++) {
+        body.push_back(cycle[next]);
+        body.erase(body.begin());
+        if (++next == cycle.size()) next = 0;
+    }
+    auto t1 = Clock::now();
+    volatile int sink = body.back().x; (void)sink;
+    return chrono::duration<double, nano>(t1 - t0).count() / TICKS;
+}
+
+double BenchRingBody(const vector<Point>& cycle, size_t len) {
+    RingBuffer<Point> body(cycle.size());
+    for (size_t i = 0; i < len; i++) body.push_back(cycle[i]);
+    size_t next = len;
+    auto t0 = Clock::now();
+    for (long long i = 0; i < TICKS; i++) {
+        body.push_back(cycle[next]);
+        body.pop_front();
+        if (++next == cycle.size()) next = 0;
+    }
+    auto t1 = Clock::now();
+    volatile int sink = body.back().x; (void)sink;
+    return chrono::duration<double, nano>(t1 - t0).count() / TICKS;
+}
+
+// SnakeSim::Step đầy đủ (tường, tự cắn, bitboard, thân rắn), mồi và cổng tắt để rắn chỉ đi vòng
+double BenchSimStep(const vector<MapData>& maps, const vector<Point>& cycle, size_t len) {
+    SnakeSim sim;
+    sim.levels = &maps;
+    sim.Reset(1);
+    PlaceSnakeOnCycle(sim, cycle, len);
+
+    size_t next = len;
+    auto t0 = Clock::now();
+    for (long long i = 0; i < TICKS; i++) {
+        sim.Step(DirTo(sim.snake.back(), cycle[next]));
+        if (++next == cycle.size()) next = 0;
+    }
+    auto t1 = Clock::now();
+    if (!sim.alive) printf("  (snake died, result invalid)\n");
+    return chrono::duration<double, nano>(t1 - t0).count() / TICKS;
+}
+
+int main() {
+    vector<MapData> maps{ MakeOpenBoard(BOARD_W, BOARD_H) };
+
+    vector<Point> cycle = BuildCycle(BOARD_W - 1, BOARD_H - 1);
+    printf("Board %dx%d, cycle %zu cells, %lld ticks per row\n\n", BOARD_W, BOARD_H, cycle.size(), TICKS);
+    printf("%8s  %14s  %14s  %14s\n", "length", "vector ns/tick", "ring ns/tick", "Step ns/tick");
+
+    size_t lengths[] = { 8, 64, 512, 1024, 2048, 4096, 8000 };
+    for (size_t len : lengths) {
+        double v = BenchVectorBody(cycle, len);
+        double r = BenchRingBody(cycle, len);
+        double s = BenchSimStep(maps, cycle, len);
+        printf("%8zu  %14.2f  %14.2f  %14.2f\n", len, v, r, s);
+    }
+    return 0;
+}
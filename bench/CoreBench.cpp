@@ -0,0 +1,371 @@
+// CoreBench.cpp — Bộ benchmark các thao tác chính của game, kết quả JSON để theo dõi hồi quy
+//
+// Cách chạy giống Google Benchmark: mỗi benchmark tăng số lần lặp tới khi chạy đủ thời gian tối
+// thiểu, in ns/lần. File JSON có cùng dạng ("context" + "benchmarks" với name, iterations,
+// real_time, time_unit), nên công cụ so sánh của Google Benchmark đọc được. Mọi dữ liệu ngẫu
+// nhiên (điểm truy vấn, seed ván, nhật ký điểm) sinh từ --seed nên hai lần chạy đo cùng một việc.
+//
+// Build: g++ -O2 -std=c++17 -I.. CoreBench.cpp ../SnakeSim.cpp ../SnakeSave.cpp ../MappedFile.cpp ../HighScoreStore.cpp ../MapPack.cpp -o CoreBench
+// Dùng:  CoreBench [--benchmark_filter=regex] [--benchmark_min_time=giây] [--benchmark_out=file.json]
+//                  [--benchmark_format=json] [--seed=N]
+
+#include "BenchUtil.h"
+#include "SnakeSave.h"
+#include "HighScoreStore.h"
+#include "MapPack.h"
+#include "Board.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+const int BOARD_W = 130;   // Giống BodyBench/SpawnBench: vùng chơi 129x64, có chu trình qua mọi ô
+const int BOARD_H = 65;
+const int QUERY_COUNT = 4096;  // Số điểm truy vấn dựng sẵn cho HitSelf/Occupied (lũy thừa của 2)
+
+// Giữ giá trị lại để trình biên dịch không bỏ vòng lặp đo
+template <typename T>
+inline void Keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile char sink;
+    sink = *(const volatile char*)&value;
+#endif
+}
+
+// Một benchmark: Setup chuẩn bị dữ liệu (không tính giờ) và trả về hàm chạy n lần thao tác cần đo
+struct Benchmark {
+    string name;
+    function<function<void(uint64_t)>()> setup;
+};
+
+struct BenchResult {
+    string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0;
+};
+
+uint64_t seedBase = 1;
+
+vector<MapData>& BenchMaps() {
+    static vector<MapData> maps{ MakeOpenBoard(BOARD_W, BOARD_H) };
+    return maps;
+}
+
+const vector<Point>& BenchCycle() {
+    static vector<Point> cycle = BuildCycle(BOARD_W - 1, BOARD_H - 1);
+    return cycle;
+}
+
+// Sim trên bàn trống với rắn dài len nằm dọc chu trình, mồi và cổng tắt
+SnakeSim MakeSim(size_t len) {
+    SnakeSim sim;
+    sim.levels = &BenchMaps();
+    sim.Reset(seedBase);
+    PlaceSnakeOnCycle(sim, BenchCycle(), len);
+    return sim;
+}
+
+vector<Point> MakeQueries() {
+    Pcg32 rng;
+    rng.Seed(seedBase ^ 0x51ed270b);
+    vector<Point> queries(QUERY_COUNT);
+    for (Point& p : queries) p = { (int)rng.Below(BOARD_W - 1) + 1, (int)rng.Below(BOARD_H - 1) + 1 };
+    return queries;
+}
+
+// Nhật ký điểm count dòng, nhiều người chơi trùng tên như bảng xếp hạng thật
+void WriteScoreLog(const string& path, size_t count) {
+    Pcg32 rng;
+    rng.Seed(seedBase ^ 0x2545f491);
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+    for (size_t i = 0; i < count; i++)
+        fprintf(f, "player%u|%u|%u|2024-01-01\n", rng.Below(50000), rng.Below(100000), rng.Below(MAX_SPEED) + 1);
+    fclose(f);
+}
+
+void RegisterStep(vector<Benchmark>& list, size_t len) {
+    list.push_back({ "Step/len:" + to_string(len), [len] {
+        auto sim = make_shared<SnakeSim>(MakeSim(len));
+        auto next = make_shared<size_t>(len);
+        return function<void(uint64_t)>([sim, next](uint64_t n) {
+            const vector<Point>& cycle = BenchCycle();
+            for (uint64_t i = 0; i < n; i++) {
+                sim->Step(DirTo(sim->snake.back(), cycle[*next]));
+                if (++*next == cycle.size()) *next = 0;
+            }
+            Keep(sim->alive);
+        });
+    } });
+}
+
+// Như Step nhưng chạy bằng FixedBoardSim<BOARD_W, BOARD_H> (Board.h): cùng ván, cùng dãy hướng
+void RegisterFixedStep(vector<Benchmark>& list, size_t len) {
+    list.push_back({ "FixedStep/len:" + to_string(len), [len] {
+        auto sim = make_shared<FixedBoardSim<BOARD_W, BOARD_H>>();
+        sim->Load(MakeSim(len));
+        auto next = make_shared<size_t>(len);
+        return function<void(uint64_t)>([sim, next](uint64_t n) {
+            const vector<Point>& cycle = BenchCycle();
+            for (uint64_t i = 0; i < n; i++) {
+                sim->Step(DirTo(sim->Head(), cycle[*next]));
+                if (++*next == cycle.size()) *next = 0;
+            }
+            Keep(sim->Alive());
+        });
+    } });
+}
+
+// HitSelf và Occupied: truy vấn các điểm ngẫu nhiên trên bàn có rắn dài len
+void RegisterQuery(vector<Benchmark>& list, const string& op, size_t len) {
+    bool self = op == "HitSelf";
+    list.push_back({ op + "/len:" + to_string(len), [len, self] {
+        auto sim = make_shared<SnakeSim>(MakeSim(len));
+        auto queries = make_shared<vector<Point>>(MakeQueries());
+        return function<void(uint64_t)>([sim, queries, self](uint64_t n) {
+            int hits = 0;
+            for (uint64_t i = 0; i < n; i++) {
+                const Point& p = (*queries)[i & (QUERY_COUNT - 1)];
+                hits += self ? sim->HitSelf(p) : sim->Occupied(p);
+            }
+            Keep(hits);
+        });
+    } });
+}
+
+void RegisterFoods(vector<Benchmark>& list, double fill) {
+    char name[48];
+    snprintf(name, sizeof(name), "GenerateFoods/fill:%g", fill * 100);
+    list.push_back({ name, [fill] {
+        auto sim = make_shared<SnakeSim>(MakeSim((size_t)(fill * BenchCycle().size())));
+        return function<void(uint64_t)>([sim](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) Keep(sim->GenerateFoods());
+        });
+    } });
+}
+
+// Mở bảng xếp hạng: "cold" không có chỉ mục nên quét cả nhật ký, "warm" chỉ đọc chỉ mục
+void RegisterHighScores(vector<Benchmark>& list, size_t entries, bool cold) {
+    list.push_back({ string("LoadHighScores/") + (cold ? "cold" : "warm") + "/entries:" + to_string(entries), [entries, cold] {
+        string path = "corebench_scores_" + to_string(entries) + ".txt";
+        WriteScoreLog(path, entries);
+        remove((path + ".idx").c_str());
+        if (!cold) HighScoreStore().Open(path);
+        return function<void(uint64_t)>([path, cold](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                if (cold) remove((path + ".idx").c_str());
+                HighScoreStore store;
+                store.Open(path);
+                Keep(store.Top(15).size());
+            }
+        });
+    } });
+}
+
+// Lưu rồi nạp lại snapshot qua file (đường SaveToFile/LoadFromFile của bản console)
+void RegisterSaveLoad(vector<Benchmark>& list, size_t len) {
+    list.push_back({ "SaveLoadRoundTrip/len:" + to_string(len), [len] {
+        auto sim = make_shared<SnakeSim>(MakeSim(len));
+        auto loaded = make_shared<SnakeSim>();
+        loaded->levels = &BenchMaps();
+        return function<void(uint64_t)>([sim, loaded](uint64_t n) {
+            const string path = "corebench.sav";
+            bool ok = true;
+            for (uint64_t i = 0; i < n; i++) ok &= SaveSnapshot(*sim, path) && LoadSnapshot(*loaded, path);
+            if (!ok) printf("  (save/load failed, result invalid)\n");
+            Keep(loaded->snake.size());
+        });
+    } });
+}
+
+// Chỉ mã hóa/giải mã trong bộ nhớ, tách chi phí định dạng khỏi chi phí file
+void RegisterSnapshot(vector<Benchmark>& list, size_t len) {
+    list.push_back({ "SnapshotEncodeDecode/len:" + to_string(len), [len] {
+        auto sim = make_shared<SnakeSim>(MakeSim(len));
+        auto loaded = make_shared<SnakeSim>();
+        loaded->levels = &BenchMaps();
+        auto buffer = make_shared<vector<uint8_t>>();
+        return function<void(uint64_t)>([sim, loaded, buffer](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                EncodeSnapshot(*sim, *buffer);
+                Keep(DecodeSnapshot(*loaded, buffer->data(), buffer->size()));
+            }
+        });
+    } });
+}
+
+vector<Benchmark> AllBenchmarks() {
+    vector<Benchmark> list;
+    size_t lengths[] = { 8, 512, 4096, 8000 };
+    for (size_t len : lengths) RegisterStep(list, len);
+    for (size_t len : lengths) RegisterFixedStep(list, len);
+    for (size_t len : lengths) RegisterQuery(list, "HitSelf", len);
+    for (size_t len : lengths) RegisterQuery(list, "Occupied", len);
+    double fills[] = { 0.01, 0.5, 0.9, 0.99, 0.999 };
+    for (double fill : fills) RegisterFoods(list, fill);
+    for (size_t entries : { (size_t)10000, (size_t)1000000 }) {
+        RegisterHighScores(list, entries, true);
+        RegisterHighScores(list, entries, false);
+    }
+    RegisterSaveLoad(list, 8);
+    RegisterSaveLoad(list, 8000);
+    RegisterSnapshot(list, 8);
+    RegisterSnapshot(list, 8000);
+    list.push_back({ "InitializeLevelMaps", [] {
+        return function<void(uint64_t)>([](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                vector<MapData> maps;
+                InitializeLevelMaps(maps);
+                Keep(maps.size());
+            }
+        });
+    } });
+    // Cùng 5 map nhưng đọc từ gói nhị phân trong bộ nhớ (như levels.pack đã ánh xạ)
+    list.push_back({ "MapPackLoadAll", [] {
+        auto pack = make_shared<vector<uint8_t>>();
+        vector<MapData> builtin;
+        InitializeLevelMaps(builtin);
+        EncodeMapPack(builtin, *pack);
+        return function<void(uint64_t)>([pack](uint64_t n) {
+            for (uint64_t i = 0; i < n; i++) {
+                MapPack reader;
+                vector<MapData> maps;
+                reader.Open(pack->data(), pack->size());
+                reader.LoadAll(maps);
+                Keep(maps.size());
+            }
+        });
+    } });
+    return list;
+}
+
+// Tăng số lần lặp (gấp tối đa 10 lần mỗi vòng) tới khi một lần đo chạy đủ minTime giây
+BenchResult Run(const Benchmark& bench, double minTime) {
+    function<void(uint64_t)> body = bench.setup();
+    BenchResult r;
+    r.name = bench.name;
+    uint64_t iters = 1;
+    while (true) {
+        auto t0 = Clock::now();
+        body(iters);
+        double seconds = chrono::duration<double>(Clock::now() - t0).count();
+        if (seconds >= minTime || iters >= 1000000000ull) {
+            r.iterations = iters;
+            r.nsPerOp = seconds * 1e9 / iters;
+            return r;
+        }
+        double scale = seconds > 0 ? minTime * 1.4 / seconds : 10.0;
+        if (scale > 10.0) scale = 10.0;
+        uint64_t grown = (uint64_t)(iters * scale);
+        iters = grown > iters ? grown : iters + 1;
+    }
+}
+
+string ToJson(const vector<BenchResult>& results, double minTime) {
+    char date[32];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    string out = "{\n  \"context\": {\n";
+    char line[512];
+    snprintf(line, sizeof(line), "    \"date\": \"%s\",\n    \"executable\": \"CoreBench\",\n    \"num_cpus\": %u,\n"
+        "    \"seed\": %llu,\n    \"min_time\": %g\n  },\n  \"benchmarks\": [\n",
+        date, thread::hardware_concurrency(), (unsigned long long)seedBase, minTime);
+    out += line;
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        snprintf(line, sizeof(line), "    {\n      \"name\": \"%s\",\n      \"run_name\": \"%s\",\n      \"run_type\": \"iteration\",\n"
+            "      \"iterations\": %llu,\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n      \"time_unit\": \"ns\"\n    }%s\n",
+            r.name.c_str(), r.name.c_str(), (unsigned long long)r.iterations, r.nsPerOp, r.nsPerOp,
+            i + 1 < results.size() ? "," : "");
+        out += line;
+    }
+    out += "  ]\n}\n";
+    return out;
+}
+
+// "--key=value": trả về value nếu arg bắt đầu bằng key=
+static const char* Option(const char* arg, const char* key) {
+    size_t n = strlen(key);
+    return strncmp(arg, key, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+}
+
+int main(int argc, char** argv) {
+    string filter, outPath;
+    double minTime = 0.2;
+    bool jsonStdout = false;
+    for (int i = 1; i < argc; i++) {
+        const char* v;
+        if ((v = Option(argv[i], "--benchmark_filter"))) filter = v;
+        else if ((v = Option(argv[i], "--benchmark_min_time"))) minTime = atof(v);
+        else if ((v = Option(argv[i], "--benchmark_out"))) outPath = v;
+        else if ((v = Option(argv[i], "--benchmark_format"))) jsonStdout = strcmp(v, "json") == 0;
+        else if ((v = Option(argv[i], "--seed"))) seedBase = strtoull(v, nullptr, 10);
+        else {
+            printf("Usage: %s [--benchmark_filter=regex] [--benchmark_min_time=s] [--benchmark_out=file.json]"
+                " [--benchmark_format=json] [--seed=N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Như Google Benchmark: tên chỉ cần chứa một đoạn khớp regex ("Step/len:(8|512)$", "^Fixed")
+    regex pattern;
+    try {
+        pattern = regex(filter.empty() ? string(".") : filter);
+    }
+    catch (const regex_error&) {
+        printf("Invalid --benchmark_filter regex: %s\n", filter.c_str());
+        return 2;
+    }
+    vector<Benchmark> selected;
+    for (const Benchmark& bench : AllBenchmarks())
+        if (regex_search(bench.name, pattern)) selected.push_back(bench);
+    if (selected.empty()) {
+        printf("No benchmark matches --benchmark_filter=%s\n", filter.c_str());
+        return 1;
+    }
+
+    vector<BenchResult> results;
+    if (!jsonStdout) printf("%-40s %14s %12s\n", "Benchmark", "Time (ns)", "Iterations");
+    for (const Benchmark& bench : selected) {
+        results.push_back(Run(bench, minTime));
+        if (!jsonStdout) {
+            printf("%-40s %14.1f %12llu\n", results.back().name.c_str(), results.back().nsPerOp,
+                (unsigned long long)results.back().iterations);
+            fflush(stdout);
+        }
+    }
+
+    // File tạm của các benchmark bảng xếp hạng và lưu/nạp
+    for (size_t entries : { (size_t)10000, (size_t)1000000 }) {
+        string path = "corebench_scores_" + to_string(entries) + ".txt";
+        remove(path.c_str());
+        remove((path + ".idx").c_str());
+    }
+    remove("corebench.sav");
+
+    string json = ToJson(results, minTime);
+    if (jsonStdout) fputs(json.c_str(), stdout);
+    if (!outPath.empty()) {
+        FILE* f = fopen(outPath.c_str(), "w");
+        if (!f || fputs(json.c_str(), f) < 0) {
+            printf("Cannot write %s\n", outPath.c_str());
+            if (f) fclose(f);
+            return 1;
+        }
+        fclose(f);
+    }
+    return 0;
+}
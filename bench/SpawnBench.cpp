@@ -0,0 +1,74 @@
+// SpawnBench.cpp — Đo thời gian đặt mồi và cổng theo độ đầy của bàn chơi
+// So sánh lấy mẫu loại bỏ (cách cũ: chọn ô ngẫu nhiên đến khi trống) với tập ô trống CellSet
+//
+// Build: g++ -O2 -std=c++17 -I.. SpawnBench.cpp ../SnakeSim.cpp -o SpawnBench
+
+#include "BenchUtil.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+const int BOARD_W = 130;
+const int BOARD_H = 65;
+const int ROUNDS = 20000;
+
+// GenerateFoods cũ: chọn ngẫu nhiên trong vùng chơi, bỏ qua ô bận
+void RejectionFoods(SnakeSim& sim) {
+    sim.foods.clear();
+    while ((int)sim.foods.size() < FOOD_COUNT) {
+        Point f{ sim.RandIndex(sim.gridWidth - 1) + 1, sim.RandIndex(sim.gridHeight - 1) + 1 };
+        if (!sim.Occupied(f)) sim.foods.push_back(f);
+    }
+}
+
+// SpawnGate cũ: chọn cạnh rồi chọn ô trên cạnh đến khi trống
+Point RejectionGate(SnakeSim& sim) {
+    Point g{};
+    do {
+        int edge = sim.RandIndex(4);
+        if (edge == 0) g = { sim.RandIndex(sim.gridWidth - 1) + 1, 1 };
+        if (edge == 1) g = { sim.RandIndex(sim.gridWidth - 1) + 1, sim.gridHeight - 1 };
+        if (edge == 2) g = { 1, sim.RandIndex(sim.gridHeight - 1) + 1 };
+        if (edge == 3) g = { sim.gridWidth - 1, sim.RandIndex(sim.gridHeight - 1) + 1 };
+    } while (sim.Occupied(g));
+    return g;
+}
+
+template <typename F>
+double TimeNs(F f) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < ROUNDS; i++) f();
+    auto t1 = Clock::now();
+    return chrono::duration<double, nano>(t1 - t0).count() / ROUNDS;
+}
+
+int main() {
+    vector<MapData> maps{ MakeOpenBoard(BOARD_W, BOARD_H) };
+    vector<Point> cycle = BuildCycle(BOARD_W - 1, BOARD_H - 1);
+
+    printf("Board %dx%d (%zu playable cells), %d rounds per row\n\n", BOARD_W, BOARD_H, cycle.size(), ROUNDS);
+    printf("%6s  %10s  %16s  %16s  %16s  %16s\n", "fill", "free", "reject foods ns", "set foods ns", "reject gate ns", "set gate ns");
+
+    double fills[] = { 0.50, 0.90, 0.99, 0.999 };
+    for (double fill : fills) {
+        SnakeSim sim;
+        sim.levels = &maps;
+        sim.Reset(1);
+        PlaceSnakeOnCycle(sim, cycle, (size_t)(fill * cycle.size()));
+
+        // Cạnh có thể bị rắn phủ kín; khi đó cách cũ sẽ lặp vô hạn nên bỏ qua cột này
+        bool borderHasFree = false;
+        for (auto& edge : sim.borderFree) borderHasFree |= !edge.Empty();
+
+        double rejectFoods = TimeNs([&] { RejectionFoods(sim); });
+        double setFoods = TimeNs([&] { sim.GenerateFoods(); });
+        double rejectGate = borderHasFree ? TimeNs([&] { RejectionGate(sim); }) : -1;
+        double setGate = TimeNs([&] { sim.SpawnGate(); });
+        printf("%5.1f%%  %10d  %16.1f  %16.1f  %16.1f  %16.1f\n", fill * 100, sim.freeCells.Size(),
+            rejectFoods, setFoods, rejectGate, setGate);
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+// ArenaRunner.cpp — Chạy chế độ đấu trường (Arena.h) không giao diện: hàng trăm bot trên một bản đồ lớn,
+// con chết được sinh lại ngay để số đầu rắn không đổi, in thời gian mỗi tick và mỗi đầu rắn
+//
+// --check: mỗi tick so kết quả va chạm của lưới chủ sở hữu với cách quét từng cặp (chậm, chỉ để kiểm
+// tra) và kiểm tra lưới khớp với thân rắn; trả về 1 nếu có sai khác.
+//
+// Build: g++ -O2 -std=c++17 -I.. ArenaRunner.cpp ../Arena.cpp ../SnakeSim.cpp -o ArenaRunner
+// Dùng:  ArenaRunner [số rắn] [rộng] [cao] [số tick] [seed] [độ dài ban đầu] [--check]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "Arena.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// Bản đồ mở có viền, thêm các khối tường rải đều để bot phải lượn
+static MapData MakeArenaMap(int width, int height) {
+    MapData map;
+    map.width = width;
+    map.height = height;
+    map.startPos = { width / 2, height / 2 };
+    map.themeName = "Arena";
+    map.backgroundColor = 7;
+    InitMapTiles(map);
+    for (int y = 16; y + 4 < height; y += 24)
+        for (int x = 16; x + 4 < width; x += 24)
+            for (int dy = 0; dy < 4; dy++)
+                for (int dx = 0; dx < 4; dx++) SetTile(map, x + dx, y + dy, TILE_WALL);
+    return map;
+}
+
+static Point Move(const Point& p, int dir) {
+    if (dir == DIR_LEFT) return { p.x - 1, p.y };
+    if (dir == DIR_RIGHT) return { p.x + 1, p.y };
+    if (dir == DIR_UP) return { p.x, p.y - 1 };
+    return { p.x, p.y + 1 };
+}
+
+// Cách làm cũ: so đầu mới của mỗi con với mọi đoạn thân và mọi đầu khác
+static vector<uint8_t> PairwiseDeaths(const Arena& arena, const vector<int>& dirs) {
+    size_t n = arena.snakes.size();
+    vector<Point> next(n);
+    for (size_t i = 0; i < n; i++) {
+        const ArenaSnake& s = arena.snakes[i];
+        if (!s.alive) continue;
+        int dir = CanChangeDirection(dirs[i], s.moving, s.body.size()) ? dirs[i] : s.moving;
+        next[i] = Move(s.body.back(), dir);
+    }
+    vector<uint8_t> dies(n, 0);
+    for (size_t i = 0; i < n; i++) {
+        if (!arena.snakes[i].alive) continue;
+        bool dead = IsBlocked(*arena.map, next[i]);
+        for (size_t j = 0; j < n && !dead; j++) {
+            if (!arena.snakes[j].alive) continue;
+            if (j != i && next[j] == next[i]) dead = true;
+            for (const Point& p : arena.snakes[j].body)
+                if (p == next[i]) dead = true;
+        }
+        dies[i] = dead;
+    }
+    return dies;
+}
+
+// Lưới chủ sở hữu khớp đúng với thân các con đang sống
+static bool GridConsistent(const Arena& arena) {
+    size_t cells = 0;
+    for (size_t i = 0; i < arena.snakes.size(); i++) {
+        for (const Point& p : arena.snakes[i].body) {
+            if (arena.Owner(p) != (int)i || arena.HasFood(p)) return false;
+            cells++;
+        }
+    }
+    size_t owned = 0;
+    for (int y = 0; y <= arena.map->height; y++)
+        for (int x = 0; x <= arena.map->width; x++) owned += arena.Owner({ x, y }) >= 0;
+    return owned == cells;
+}
+
+int main(int argc, char** argv) {
+    vector<const char*> args;
+    bool check = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--check") == 0) check = true;
+        else args.push_back(argv[i]);
+    }
+    int snakeCount = args.size() > 0 ? atoi(args[0]) : 500;
+    int width = args.size() > 1 ? atoi(args[1]) : 512;
+    int height = args.size() > 2 ? atoi(args[2]) : 256;
+    uint64_t tickCount = args.size() > 3 ? strtoull(args[3], nullptr, 10) : 20000;
+    uint64_t seed = args.size() > 4 ? strtoull(args[4], nullptr, 10) : 1;
+    int startLength = args.size() > 5 ? atoi(args[5]) : 8;
+    if (snakeCount <= 0 || width < 8 || height < 8 || startLength <= 0) {
+        printf("Usage: %s [snakes] [width] [height] [ticks] [seed] [startLength] [--check]\n", argv[0]);
+        return 2;
+    }
+
+    MapData map = MakeArenaMap(width, height);
+    Arena arena;
+    if (!arena.Reset(map, snakeCount, seed, snakeCount, startLength)) {
+        printf("Board %dx%d is larger than %d cells\n", width, height, DENSE_BOARD_CELLS);
+        return 2;
+    }
+    vector<int> dirs(snakeCount);
+
+    double stepSeconds = 0;
+    uint64_t heads = 0, deaths = 0, bodyCells = 0, mismatches = 0;
+    for (uint64_t t = 0; t < tickCount; t++) {
+        for (int i = 0; i < snakeCount; i++) dirs[i] = arena.WanderDirection(i);
+        heads += arena.aliveCount;
+
+        vector<uint8_t> expected;
+        if (check) expected = PairwiseDeaths(arena, dirs);
+        vector<uint8_t> wasAlive(snakeCount);
+        for (int i = 0; i < snakeCount; i++) wasAlive[i] = arena.snakes[i].alive;
+
+        auto t0 = Clock::now();
+        deaths += arena.Step(dirs.data());
+        stepSeconds += chrono::duration<double>(Clock::now() - t0).count();
+
+        if (check) {
+            for (int i = 0; i < snakeCount; i++)
+                if (wasAlive[i] && expected[i] == arena.snakes[i].alive) mismatches++;
+            if (!GridConsistent(arena)) mismatches++;
+        }
+        for (const ArenaSnake& s : arena.snakes) bodyCells += s.body.size();
+        for (int i = 0; i < snakeCount; i++) arena.Respawn(i);
+    }
+
+    int maxLength = 0, bestScore = 0;
+    for (const ArenaSnake& s : arena.snakes) {
+        maxLength = max(maxLength, (int)s.body.size());
+        bestScore = max(bestScore, s.score);
+    }
+    printf("Arena %dx%d, %d snakes, %llu ticks, seed %llu\n", width, height, snakeCount,
+        (unsigned long long)tickCount, (unsigned long long)seed);
+    printf("Mean length %.1f, longest %d, best score %d, %.2f deaths/tick\n",
+        (double)bodyCells / tickCount / snakeCount, maxLength, bestScore, (double)deaths / tickCount);
+    printf("Step: %.2f us/tick, %.1f ns/head\n", stepSeconds * 1e6 / tickCount, stepSeconds * 1e9 / heads);
+    if (check) printf("Check vs pairwise scan: %s (%llu mismatches)\n", mismatches ? "MISMATCH" : "MATCH",
+        (unsigned long long)mismatches);
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,153 @@
+// BatchRunner.cpp — Chạy rất nhiều ván bot độc lập trên mọi lõi CPU để đánh giá chính sách
+// Mỗi ván có SnakeSim và seed riêng (suy ra từ seed gốc + số thứ tự ván), nên kết quả
+// không phụ thuộc số luồng; các ván được chia cho luồng bằng work-stealing (WorkStealingPool.h)
+//
+// Build: g++ -O2 -std=c++17 -pthread -I.. BatchRunner.cpp ../SnakeSim.cpp ../SnakePolicy.cpp ../Autopilot.cpp ../CyclePilot.cpp -o BatchRunner
+// Dùng:  BatchRunner [số ván] [số luồng] [chính sách] [seed] [số bước tối đa mỗi ván] [bàn WxH]
+//        chính sách: straight, random, greedy, autopilot, cycle
+//        bàn WxH: chơi trên một bàn trống WxH (tới 65535x65535) thay cho 5 map mặc định
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SnakePolicy.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// Số ván mỗi khúc việc: đủ lớn để khóa hàng đợi không đáng kể, đủ nhỏ để còn việc mà lấy trộm
+const size_t GAMES_PER_CHUNK = 64;
+
+// Trộn seed gốc với số thứ tự ván (splitmix64) để các ván liền nhau không có seed gần nhau
+static uint64_t GameSeed(uint64_t base, uint64_t index) {
+    uint64_t z = base + (index + 1) * 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Thống kê riêng của từng luồng, mỗi luồng một cache line
+struct alignas(64) WorkerStats {
+    uint64_t games = 0;
+    uint64_t ticks = 0;
+    uint64_t totalLength = 0;
+    uint64_t boardFull = 0;  // Ván kết thúc vì đầy bàn
+    uint64_t timeouts = 0;   // Ván bị cắt ở maxTicks
+    size_t peakBoardBytes = 0;  // Bitboard thân rắn lớn nhất lúc kết thúc ván
+};
+
+int main(int argc, char** argv) {
+    size_t games = argc > 1 ? strtoull(argv[1], nullptr, 10) : 100000;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    string policyName = argc > 3 ? argv[3] : "greedy";
+    uint64_t seed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 1;
+    uint64_t maxTicks = argc > 5 ? strtoull(argv[5], nullptr, 10) : 100000;
+    int boardW = 0, boardH = 0;
+    if (argc > 6 && sscanf(argv[6], "%dx%d", &boardW, &boardH) != 2) boardW = -1;
+    if (threads <= 0) threads = max(1u, thread::hardware_concurrency());
+
+    bool badBoard = argc > 6 && (boardW < 16 || boardH < 8 || boardW > MAX_BOARD_SIZE || boardH > MAX_BOARD_SIZE);
+    if (games == 0 || !MakePolicy(policyName, 0) || badBoard) {
+        printf("Usage: %s [games] [threads] [straight|random|greedy|autopilot|cycle] [seed] [maxTicks] [WxH]\n", argv[0]);
+        return 2;
+    }
+
+    // Bàn trống tùy chọn: mọi level dùng cùng một map, tiles chỉ có khối viền
+    vector<MapData> board;
+    int boardCycle = CYCLE_TOO_LARGE;
+    if (boardW > 0) {
+        board.resize(1);
+        board[0].width = boardW;
+        board[0].height = boardH;
+        board[0].startPos = { boardW / 2, boardH / 2 };
+        board[0].themeName = "Open";
+        board[0].backgroundColor = 7;
+        InitMapTiles(board[0]);
+        boardCycle = BuildHamiltonCycle(board[0]);
+    }
+
+    vector<int> scores(games);
+    vector<WorkerStats> stats(threads);
+
+    auto t0 = Clock::now();
+    ParallelFor(games, GAMES_PER_CHUNK, threads, [&](int worker, size_t begin, size_t end) {
+        WorkerStats& st = stats[worker];
+        SnakeSim sim; // Dùng lại giữa các ván của khúc: không cấp phát lại thân rắn, bitboard
+        if (!board.empty()) sim.levels = &board;
+        for (size_t i = begin; i < end; i++) {
+            uint64_t gameSeed = GameSeed(seed, i);
+            SnakePolicy policy = MakePolicy(policyName, gameSeed ^ 0x5bd1e995u);
+            sim.Reset(gameSeed);
+            int events = PlayGame(sim, policy, maxTicks);
+
+            scores[i] = sim.score;
+            st.games++;
+            st.ticks += sim.ticks;
+            st.totalLength += sim.snake.size();
+            if (events & EVT_BOARD_FULL) st.boardFull++;
+            else if (sim.alive) st.timeouts++;
+            st.peakBoardBytes = max(st.peakBoardBytes, sim.occupancy.MemoryBytes());
+        }
+    });
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+
+    WorkerStats total;
+    for (const WorkerStats& st : stats) {
+        total.games += st.games;
+        total.ticks += st.ticks;
+        total.totalLength += st.totalLength;
+        total.boardFull += st.boardFull;
+        total.timeouts += st.timeouts;
+        total.peakBoardBytes = max(total.peakBoardBytes, st.peakBoardBytes);
+    }
+
+    vector<int> sorted(scores);
+    sort(sorted.begin(), sorted.end());
+    auto pct = [&](double p) { return sorted[(size_t)(p * (sorted.size() - 1))]; };
+    double meanScore = 0;
+    for (int s : scores) meanScore += s;
+    meanScore /= games;
+
+    printf("Policy %s, %zu games, %d threads, seed %llu\n",
+        policyName.c_str(), games, threads, (unsigned long long)seed);
+    printf("Score: mean %.1f, min %d, p10 %d, p50 %d, p90 %d, p99 %d, max %d\n",
+        meanScore, sorted.front(), pct(0.10), pct(0.50), pct(0.90), pct(0.99), sorted.back());
+    printf("Mean length %.2f, mean ticks %.1f, board full %llu, timed out %llu\n",
+        (double)total.totalLength / games, (double)total.ticks / games,
+        (unsigned long long)total.boardFull, (unsigned long long)total.timeouts);
+
+    // Phân bố điểm: 10 khoảng đều từ min tới max
+    int lo = sorted.front(), hi = sorted.back();
+    int width = max(1, (hi - lo + 10) / 10);
+    size_t bucket[10] = {};
+    for (int s : scores) bucket[min(9, (s - lo) / width)]++;
+    for (int b = 0; b < 10; b++) {
+        if (!bucket[b]) continue;
+        int barLen = (int)(50.0 * bucket[b] / games + 0.5);
+        printf("  %6d-%-6d %9zu %s\n", lo + b * width, lo + (b + 1) * width - 1, bucket[b], string(barLen, '#').c_str());
+    }
+
+    if (!board.empty()) {
+        printf("Board %dx%d: tiles %.1f KB, body bitboard peak %.1f KB\n", boardW, boardH,
+            board[0].tiles.MemoryBytes() / 1024.0, total.peakBoardBytes / 1024.0);
+    }
+    // Bot cycle chỉ không bao giờ chết trên map có chu trình; map khác chạy bằng Autopilot
+    if (policyName == "cycle") {
+        if (!board.empty()) printf("Board %dx%d: %s\n", boardW, boardH, CycleResultText(boardCycle));
+        for (size_t i = 0; board.empty() && i < DefaultLevelMaps().size(); i++) {
+            MapData map = DefaultLevelMaps()[i];
+            printf("Level %zu %s: %s\n", i + 1, map.themeName.c_str(), CycleResultText(BuildHamiltonCycle(map)));
+        }
+    }
+    printf("%.3f s, %.0f games/s, %.2f M ticks/s (%.2f M per thread)\n",
+        seconds, games / seconds, total.ticks / seconds / 1e6, total.ticks / seconds / 1e6 / threads);
+    printf("Games per thread:");
+    for (const WorkerStats& st : stats) printf(" %llu", (unsigned long long)st.games);
+    printf("\n");
+    return 0;
+}
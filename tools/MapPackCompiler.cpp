@@ -0,0 +1,100 @@
+// MapPackCompiler.cpp — Dịch các file .map (text) thành một gói màn chơi nhị phân cho game nạp bằng mmap
+// Màn trong gói theo đúng thứ tự file trên dòng lệnh (CMake truyền maps/*.map đã sắp xếp theo tên);
+// chu trình Hamilton của từng màn được tìm ở đây và lưu vào gói
+//
+// Build: g++ -O2 -std=c++17 -I.. MapPackCompiler.cpp ../MapPack.cpp ../SnakeSim.cpp ../MappedFile.cpp -o MapPackCompiler
+// Dùng:  MapPackCompiler -o levels.pack 01-a.map 02-b.map ...
+//        MapPackCompiler --export-builtin maps   (ghi bộ map dựng sẵn ra maps/NN-ten.map)
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "MapPack.h"
+
+using namespace std;
+
+static bool ReadText(const string& path, string& text) {
+    ifstream fi(path, ios::binary);
+    if (!fi) return false;
+    ostringstream ss;
+    ss << fi.rdbuf();
+    text = ss.str();
+    return true;
+}
+
+// "Peaceful Garden" -> "peaceful-garden"
+static string Slug(const string& name) {
+    string s;
+    for (char c : name) {
+        if (isalnum((unsigned char)c)) s += (char)tolower((unsigned char)c);
+        else if (!s.empty() && s.back() != '-') s += '-';
+    }
+    while (!s.empty() && s.back() == '-') s.pop_back();
+    return s.empty() ? "level" : s;
+}
+
+static int ExportBuiltin(const string& dir) {
+    vector<MapData> maps;
+    InitializeLevelMaps(maps);
+    for (size_t i = 0; i < maps.size(); i++) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "%02zu-", i + 1);
+        string path = dir + "/" + prefix + Slug(maps[i].themeName) + ".map";
+        ofstream fo(path, ios::binary | ios::trunc);
+        fo << "# Level " << i + 1 << "\n" << FormatMapText(maps[i]);
+        if (!fo) {
+            printf("Cannot write %s\n", path.c_str());
+            return 1;
+        }
+        printf("%s\n", path.c_str());
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    string output;
+    vector<string> inputs;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--export-builtin" && i + 1 < argc) return ExportBuiltin(argv[i + 1]);
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else inputs.push_back(arg);
+    }
+    if (output.empty() || inputs.empty()) {
+        printf("Usage: %s -o <out.pack> <level.map>...\n", argv[0]);
+        printf("       %s --export-builtin <dir>\n", argv[0]);
+        return 2;
+    }
+
+    vector<MapData> maps(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        string text, error;
+        if (!ReadText(inputs[i], text)) {
+            printf("Cannot read %s\n", inputs[i].c_str());
+            return 1;
+        }
+        if (!ParseMapText(text, maps[i], error)) {
+            printf("%s: %s\n", inputs[i].c_str(), error.c_str());
+            return 1;
+        }
+        // Tìm chu trình một lần ở đây, game chỉ đọc lại; không có thì bot cycle chạy bằng Autopilot trên màn này
+        printf("%s: %s\n", inputs[i].c_str(), CycleResultText(BuildHamiltonCycle(maps[i])));
+    }
+
+    vector<uint8_t> pack;
+    if (!EncodeMapPack(maps, pack)) {
+        printf("Cannot encode %zu levels\n", maps.size());
+        return 1;
+    }
+    ofstream fo(output, ios::binary | ios::trunc);
+    fo.write((const char*)pack.data(), (streamsize)pack.size());
+    if (!fo) {
+        printf("Cannot write %s\n", output.c_str());
+        return 1;
+    }
+    printf("%s: %zu levels, %zu bytes\n", output.c_str(), maps.size(), pack.size());
+    return 0;
+}
@@ -0,0 +1,173 @@
+// MultiSimCheck.cpp — Kiểm tra MultiSim cho kết quả giống hệt từng bit với SnakeSim::Step từng ván,
+// và so sánh số bước mỗi giây
+//
+// Cả hai cách chạy cùng nhịp, cùng chính sách bot (mỗi ván một thể hiện, cùng seed), nên chỉ cần
+// một bước lệch là các ván rẽ sang hướng khác và khác nhau ở cuối.
+// Dòng "fixed" chạy lại dãy hướng của từng ván bằng FixedBoardSim<70, 20> (Board.h) rồi so sánh như trên.
+//
+// Build: g++ -O2 -std=c++17 -I.. MultiSimCheck.cpp ../SnakeSim.cpp ../SnakePolicy.cpp ../Autopilot.cpp ../CyclePilot.cpp ../MultiSim.cpp -o MultiSimCheck
+// Dùng:  MultiSimCheck [số ván] [số bước tối đa] [chính sách] [seed]
+//        Trả về 1 nếu có ván khác kết quả
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "MultiSim.h"
+#include "SnakePolicy.h"
+#include "Board.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct RunResult {
+    vector<SnakeSim> games;
+    vector<vector<int>> dirs;  // Hướng đã đi ở mỗi nhịp ván còn sống (chỉ RunSingle ghi)
+    double stepSeconds = 0;  // Chỉ tính thời gian bước mô phỏng, không tính chính sách
+    uint64_t ticks = 0;
+};
+
+static vector<SnakePolicy> MakePolicies(const string& name, const vector<uint64_t>& seeds) {
+    vector<SnakePolicy> policies;
+    for (uint64_t s : seeds) policies.push_back(MakePolicy(name, s ^ 0x5bd1e995u));
+    return policies;
+}
+
+// Từng ván một: gọi SnakeSim::Step cho mỗi ván ở mỗi nhịp
+static RunResult RunSingle(const vector<uint64_t>& seeds, const string& policyName, uint64_t maxTicks) {
+    RunResult r;
+    r.games.resize(seeds.size());
+    r.dirs.resize(seeds.size());
+    for (size_t g = 0; g < seeds.size(); g++) r.games[g].Reset(seeds[g]);
+    vector<SnakePolicy> policies = MakePolicies(policyName, seeds);
+    vector<int> dirs(seeds.size());
+
+    for (uint64_t t = 0; t < maxTicks; t++) {
+        bool any = false;
+        for (size_t g = 0; g < seeds.size(); g++) {
+            dirs[g] = r.games[g].alive ? NextDirection(r.games[g], policies[g]) : r.games[g].moving;
+            any |= r.games[g].alive;
+        }
+        if (!any) break;
+        auto t0 = Clock::now();
+        for (size_t g = 0; g < seeds.size(); g++) {
+            r.games[g].moving = dirs[g];
+            r.games[g].Step(dirs[g]);
+        }
+        r.stepSeconds += chrono::duration<double>(Clock::now() - t0).count();
+        for (size_t g = 0; g < seeds.size(); g++)
+            if (r.games[g].ticks > r.dirs[g].size()) r.dirs[g].push_back(dirs[g]);
+    }
+    for (const SnakeSim& s : r.games) r.ticks += s.ticks;
+    return r;
+}
+
+static RunResult RunMulti(const vector<uint64_t>& seeds, const string& policyName, uint64_t maxTicks) {
+    MultiSim multi;
+    multi.Reset(seeds);
+    vector<SnakePolicy> policies = MakePolicies(policyName, seeds);
+    vector<int> dirs(seeds.size());
+
+    RunResult r;
+    for (uint64_t t = 0; t < maxTicks && multi.AliveCount() > 0; t++) {
+        for (size_t g = 0; g < seeds.size(); g++) {
+            SnakeSim& s = multi.games[g];
+            dirs[g] = s.alive ? NextDirection(s, policies[g]) : s.moving;
+            s.moving = dirs[g];
+        }
+        auto t0 = Clock::now();
+        multi.Step(dirs.data());
+        r.stepSeconds += chrono::duration<double>(Clock::now() - t0).count();
+    }
+    r.games = multi.games;
+    for (const SnakeSim& s : r.games) r.ticks += s.ticks;
+    return r;
+}
+
+// Từng ván một bằng FixedBoardSim, theo dãy hướng RunSingle đã ghi; false nếu map không phải 70x20
+static bool RunFixed(const vector<uint64_t>& seeds, const RunResult& single, RunResult& r) {
+    FixedBoardSim<70, 20> fixed;
+    r.games.resize(seeds.size());
+    for (size_t g = 0; g < seeds.size(); g++) {
+        if (!fixed.Reset(seeds[g])) return false;
+        const vector<int>& dirs = single.dirs[g];
+        auto t0 = Clock::now();
+        for (int dir : dirs) fixed.Step(dir);
+        r.stepSeconds += chrono::duration<double>(Clock::now() - t0).count();
+        r.games[g] = fixed.State();
+        // RunSingle ghi hướng vào moving trước mỗi bước, kể cả bước chết
+        if (!dirs.empty()) r.games[g].moving = dirs.back();
+        r.ticks += r.games[g].ticks;
+    }
+    return true;
+}
+
+static bool SameGame(const SnakeSim& a, const SnakeSim& b) {
+    if (a.alive != b.alive || a.ticks != b.ticks || a.score != b.score || a.speedLevel != b.speedLevel ||
+        a.moving != b.moving || a.locked != b.locked || a.rng.state != b.rng.state ||
+        a.foodIndex != b.foodIndex || a.foodVisible != b.foodVisible ||
+        a.gateActive != b.gateActive || a.gatePos != b.gatePos ||
+        a.snake.size() != b.snake.size() || a.foods.size() != b.foods.size())
+        return false;
+    if (a.gridWidth != b.gridWidth || a.gridHeight != b.gridHeight) return false;
+    for (int y = 0; y < a.gridHeight; y++)
+        for (int x = 0; x < a.gridWidth; x++)
+            if (a.IsOccupied({ x, y }) != b.IsOccupied({ x, y })) return false;
+    for (size_t i = 0; i < a.snake.size(); i++)
+        if (a.snake[i] != b.snake[i]) return false;
+    for (size_t i = 0; i < a.foods.size(); i++)
+        if (a.foods[i] != b.foods[i]) return false;
+    // Thứ tự tập ô trống quyết định mồi kế tiếp
+    if (a.freeCells.cells != b.freeCells.cells) return false;
+    for (int e = 0; e < 4; e++)
+        if (a.borderFree[e].cells != b.borderFree[e].cells) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t games = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4096;
+    uint64_t maxTicks = argc > 2 ? strtoull(argv[2], nullptr, 10) : 2000;
+    string policyName = argc > 3 ? argv[3] : "random";
+    uint64_t seed = argc > 4 ? strtoull(argv[4], nullptr, 10) : 1;
+    if (games == 0 || !MakePolicy(policyName, 0)) {
+        printf("Usage: %s [games] [maxTicks] [straight|random|greedy|autopilot|cycle] [seed]\n", argv[0]);
+        return 2;
+    }
+
+    vector<uint64_t> seeds(games);
+    for (size_t g = 0; g < games; g++) seeds[g] = seed * 0x9E3779B97F4A7C15ull + g;
+
+    RunResult single = RunSingle(seeds, policyName, maxTicks);
+    printf("%zu games, %llu ticks, policy %s\n", games, (unsigned long long)single.ticks, policyName.c_str());
+    printf("  %-8s %8.2f M ticks/s\n", "Step", single.ticks / single.stepSeconds / 1e6);
+
+    bool allMatch = true;
+    {
+        RunResult multi = RunMulti(seeds, policyName, maxTicks);
+        size_t mismatches = 0;
+        for (size_t g = 0; g < games; g++)
+            if (!SameGame(single.games[g], multi.games[g])) mismatches++;
+        allMatch &= mismatches == 0;
+        printf("  %-8s %8.2f M ticks/s (x%.2f)  %s", "multi", multi.ticks / multi.stepSeconds / 1e6,
+            single.stepSeconds / multi.stepSeconds, mismatches ? "MISMATCH" : "MATCH");
+        if (mismatches) printf(" (%zu games)", mismatches);
+        printf("\n");
+    }
+
+    RunResult fixed;
+    if (!RunFixed(seeds, single, fixed)) {
+        printf("  %-8s maps are not 70x20\n", "fixed");
+    }
+    else {
+        size_t mismatches = 0;
+        for (size_t g = 0; g < games; g++)
+            if (!SameGame(single.games[g], fixed.games[g])) mismatches++;
+        allMatch &= mismatches == 0;
+        printf("  %-8s %8.2f M ticks/s (x%.2f)  %s", "fixed", fixed.ticks / fixed.stepSeconds / 1e6,
+            single.stepSeconds / fixed.stepSeconds, mismatches ? "MISMATCH" : "MATCH");
+        if (mismatches) printf(" (%zu games)", mismatches);
+        printf("\n");
+    }
+    return allMatch ? 0 : 1;
+}
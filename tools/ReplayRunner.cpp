@@ -0,0 +1,71 @@
+// ReplayRunner.cpp — Phát lại file replay qua SnakeSim::Step với tốc độ tối đa, không vẽ
+// Kiểm tra kết quả khớp với lúc ghi (hồi quy) và đo thời gian mỗi bước (tìm chỗ chậm)
+//
+// Build: g++ -O2 -std=c++17 -I.. ReplayRunner.cpp ../SnakeSim.cpp ../Replay.cpp ../MapPack.cpp ../MappedFile.cpp -o ReplayRunner
+// Dùng:  ReplayRunner last.replay [số lần lặp] [--pack levels.pack]
+//        --pack: phát lại trên gói màn chơi (bản console ghi replay trên levels.pack nếu có),
+//        mặc định bộ map dựng sẵn. Replay ghi trên bộ map khác bị từ chối (trả về 2)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Replay.h"
+#include "MapPack.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    vector<const char*> args;
+    string packPath;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--pack" && i + 1 < argc) packPath = argv[++i];
+        else args.push_back(argv[i]);
+    }
+    if (args.empty()) {
+        printf("Usage: %s <file.replay> [repeat] [--pack levels.pack]\n", argv[0]);
+        return 2;
+    }
+    int repeat = args.size() > 1 ? max(1, atoi(args[1])) : 1;
+
+    Replay replay;
+    if (!LoadReplay(replay, args[0])) {
+        printf("Cannot read replay %s\n", args[0]);
+        return 2;
+    }
+    printf("Seed %llu, %llu ticks, %zu bytes of moves\n",
+        (unsigned long long)replay.seed, (unsigned long long)replay.ticks, replay.moves.size());
+
+    vector<MapData> packMaps;
+    const vector<MapData>* levels = nullptr;
+    if (!packPath.empty()) {
+        MapPack pack;
+        if (!pack.Open(packPath) || !pack.LoadAll(packMaps)) {
+            printf("Cannot read level pack %s\n", packPath.c_str());
+            return 2;
+        }
+        levels = &packMaps;
+    }
+    if (!ReplayLevelsMatch(replay, levels)) {
+        printf("Recorded on level set %08x, %s is %08x: replay with the matching --pack\n", replay.levelHash,
+            packPath.empty() ? "built-in set" : packPath.c_str(), LevelSetHash(levels ? *levels : DefaultLevelMaps()));
+        return 2;
+    }
+
+    bool match = true;
+    SnakeSim sim;
+    auto t0 = Clock::now();
+    for (int i = 0; i < repeat; i++) match &= RunReplay(replay, sim, levels);
+    auto t1 = Clock::now();
+
+    double ns = chrono::duration<double, nano>(t1 - t0).count();
+    double perTick = replay.ticks ? ns / ((double)replay.ticks * repeat) : 0;
+    printf("Recorded: score %d, length %d, level %d\n", replay.finalScore, replay.finalLength, replay.finalLevel);
+    printf("Replayed: score %d, length %zu, level %d\n", sim.score, sim.snake.size(), sim.speedLevel);
+    printf("%.3f ms per run, %.1f ns per tick\n", ns / 1e6 / repeat, perTick);
+    printf("%s\n", match ? "MATCH" : "MISMATCH");
+    return match ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+// SnakeLoadClient.cpp — Mở nhiều phiên tới SnakeServer, dựng lại ván từ delta và đối chiếu với keyframe
+//
+// Mỗi phiên giữ một SnakeSim bản sao: áp mọi NET_DELTA, và khi keyframe định kỳ tới (cùng tick với
+// delta vừa áp) so thân rắn, mồi, cổng, điểm với bản sao. Lệch hoặc delta hỏng -> đếm lỗi, gửi
+// NET_RESYNC. In số byte mỗi delta và mỗi phiên để thấy băng thông không phụ thuộc độ dài rắn.
+// Trước đó gửi một HELLO sai phiên bản: máy chủ phải đóng riêng kết nối đó và vẫn nhận các phiên sau.
+//
+// Build: g++ -O2 -std=c++17 -I.. SnakeLoadClient.cpp ../NetProtocol.cpp ../NetSocket.cpp ../SnakeSim.cpp ../SnakeSave.cpp ../MapPack.cpp ../MappedFile.cpp -o SnakeLoadClient
+// Dùng:  SnakeLoadClient [--host H] [--port N] [--sessions N] [--seconds N] [--player] [--pack levels.pack]
+//        mặc định máy chủ tự lái (rắn dài dần); --player: máy khách gửi hướng ngẫu nhiên
+//        --pack: bộ map phải giống máy chủ, nếu không máy chủ ngắt mọi phiên
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "NetProtocol.h"
+#include "NetSocket.h"
+#include "MapPack.h"
+#include "Random.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+struct Client {
+    int fd = -1;
+    SnakeSim mirror;
+    SnakeSim check;          // Keyframe giải mã ra đây để so với bản sao
+    bool synced = false;     // Đã có keyframe, delta áp được
+    vector<uint8_t> in;
+    size_t maxLength = 0;
+};
+
+struct Totals {
+    uint64_t deltas = 0, keyframes = 0, deltaBytes = 0, keyframeBytes = 0;
+    uint64_t checked = 0, mismatches = 0, games = 0;
+    size_t maxLength = 0;
+};
+
+static uint32_t levelHash = 0;  // LevelSetHash của bộ map đang dùng, gửi trong HELLO
+
+static bool SameGame(const SnakeSim& a, const SnakeSim& b) {
+    if (a.snake.size() != b.snake.size() || a.foods != b.foods || a.score != b.score) return false;
+    if (a.foodIndex != b.foodIndex || a.foodVisible != b.foodVisible || a.speedLevel != b.speedLevel) return false;
+    if (a.gateActive != b.gateActive || (a.gateActive && a.gatePos != b.gatePos)) return false;
+    for (size_t i = 0; i < a.snake.size(); i++)
+        if (a.snake[i] != b.snake[i]) return false;
+    return true;
+}
+
+static void SendFrame(Client& c, int type, const uint8_t* payload, size_t size) {
+    vector<uint8_t> out;
+    AppendFrame(out, type, payload, size);
+    // Khung vài byte: bộ đệm gửi của socket không đầy trong bài thử này
+    NetSend(c.fd, out.data(), out.size());
+}
+
+static void HandleFrame(Client& c, int type, const uint8_t* payload, size_t size, Totals& t, Pcg32& rng, bool player) {
+    if (type == NET_KEYFRAME) {
+        t.keyframes++;
+        t.keyframeBytes += NET_FRAME_HEADER + size;
+        if (!ApplyKeyframe(c.check, payload, size, levelHash)) {
+            t.mismatches++;
+            return;
+        }
+        // Keyframe định kỳ đi sau delta cùng tick: bản sao phải giống hệt
+        if (c.synced && c.mirror.alive && c.check.ticks == c.mirror.ticks) {
+            t.checked++;
+            if (!SameGame(c.mirror, c.check)) t.mismatches++;
+        }
+        if (c.check.ticks == 0) t.games++;
+        swap(c.mirror, c.check);
+        c.synced = true;
+    }
+    else if (type == NET_DELTA) {
+        t.deltas++;
+        t.deltaBytes += NET_FRAME_HEADER + size;
+        if (!c.synced) return;
+        bool dead = false;
+        if (!ApplyDelta(c.mirror, payload, size, dead)) {
+            t.mismatches++;
+            c.synced = false;
+            SendFrame(c, NET_RESYNC, nullptr, 0);
+            return;
+        }
+        c.maxLength = max(c.maxLength, c.mirror.snake.size());
+        if (player && !dead && rng.Below(8) == 0) {
+            uint8_t dir = (uint8_t)rng.Below(4);
+            SendFrame(c, NET_INPUT, &dir, 1);
+        }
+    }
+}
+
+// HELLO sai phiên bản, kèm một khung INPUT trong cùng gói: true nếu máy chủ đóng kết nối trong 2 giây
+static bool ProbeMalformedHello(const string& host, int port) {
+    int fd = NetConnect(host, port);
+    if (fd < 0 || !NetSetNonBlocking(fd)) return false;
+    vector<uint8_t> out;
+    uint8_t hello[2] = { (uint8_t)(NET_VERSION + 8), 0 };
+    AppendFrame(out, NET_HELLO, hello, 2);
+    uint8_t dir = DIR_LEFT;
+    AppendFrame(out, NET_INPUT, &dir, 1);
+    NetSend(fd, out.data(), out.size());
+
+    auto deadline = Clock::now() + chrono::seconds(2);
+    bool closed = false;
+    uint8_t buf[256];
+    while (!closed && Clock::now() < deadline) {
+        long got = NetRecv(fd, buf, sizeof(buf));
+        if (got < 0) closed = true;
+        else if (got == 0) this_thread::sleep_for(chrono::milliseconds(10));
+    }
+    NetClose(fd);
+    return closed;
+}
+
+static void RaiseFileLimit() {
+    rlimit lim{};
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int main(int argc, char** argv) {
+    string host = "127.0.0.1";
+    int port = NET_DEFAULT_PORT;
+    int sessions = 100;
+    double seconds = 10;
+    bool player = false;
+    string packPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--player") player = true;
+        else if (i + 1 < argc && arg == "--pack") packPath = argv[++i];
+        else if (i + 1 < argc && arg == "--host") host = argv[++i];
+        else if (i + 1 < argc && arg == "--port") port = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--sessions") sessions = atoi(argv[++i]);
+        else if (i + 1 < argc && arg == "--seconds") seconds = atof(argv[++i]);
+        else {
+            printf("Usage: %s [--host H] [--port N] [--sessions N] [--seconds N] [--player] [--pack levels.pack]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    vector<MapData> packMaps;
+    const vector<MapData>* levels = nullptr;
+    if (!packPath.empty()) {
+        MapPack pack;
+        if (!pack.Open(packPath) || !pack.LoadAll(packMaps)) {
+            printf("Cannot read level pack %s\n", packPath.c_str());
+            return 2;
+        }
+        levels = &packMaps;
+    }
+    levelHash = LevelSetHash(levels ? *levels : DefaultLevelMaps());
+
+    RaiseFileLimit();
+    // Máy chủ sập ở đây thì các kết nối dưới đây cũng thất bại
+    bool probeOk = ProbeMalformedHello(host, port);
+    printf("malformed HELLO: %s\n", probeOk ? "closed by server" : "NOT closed");
+
+    int epollFd = epoll_create1(0);
+    vector<Client> clients(max(sessions, 0));
+    for (size_t i = 0; i < clients.size(); i++) {
+        Client& c = clients[i];
+        c.fd = NetConnect(host, port);
+        if (c.fd < 0 || !NetSetNonBlocking(c.fd)) {
+            printf("Connect %s:%d failed after %zu sessions\n", host.c_str(), port, i);
+            return 1;
+        }
+        c.mirror.levels = c.check.levels = levels;
+        vector<uint8_t> hello;
+        AppendHello(hello, player ? 0 : NET_HELLO_AUTOPILOT, levelHash);
+        NetSend(c.fd, hello.data(), hello.size());
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, c.fd, &ev);
+    }
+
+    Totals t;
+    Pcg32 rng;
+    rng.Seed(12345);
+    auto start = Clock::now();
+    auto end = start + chrono::duration_cast<Clock::duration>(chrono::duration<double>(seconds));
+    size_t closed = 0;
+    epoll_event events[256];
+    uint8_t buf[16384];
+    while (Clock::now() < end && closed < clients.size()) {
+        int n = epoll_wait(epollFd, events, 256, 100);
+        for (int e = 0; e < n; e++) {
+            Client& c = clients[events[e].data.u64];
+            if (c.fd < 0) continue;
+            bool open = true;
+            while (true) {
+                long got = NetRecv(c.fd, buf, sizeof(buf));
+                if (got < 0) open = false;
+                if (got <= 0) break;
+                c.in.insert(c.in.end(), buf, buf + got);
+            }
+            size_t pos = 0;
+            int type;
+            const uint8_t* payload;
+            size_t size;
+            while (NextFrame(c.in.data(), c.in.size(), pos, type, payload, size)) HandleFrame(c, type, payload, size, t, rng, player);
+            c.in.erase(c.in.begin(), c.in.begin() + pos);
+            if (!open) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+                NetClose(c.fd);
+                c.fd = -1;
+                closed++;
+            }
+        }
+    }
+    double elapsed = chrono::duration<double>(Clock::now() - start).count();
+
+    for (Client& c : clients) {
+        t.maxLength = max(t.maxLength, c.maxLength);
+        NetClose(c.fd);
+    }
+    uint64_t bytes = t.deltaBytes + t.keyframeBytes;
+    printf("%zu sessions, %.1fs, %zu closed by server\n", clients.size(), elapsed, closed);
+    printf("deltas %llu (%.2f B avg) | keyframes %llu (%.1f B avg) | games %llu | longest snake %zu\n",
+        (unsigned long long)t.deltas, t.deltas ? (double)t.deltaBytes / t.deltas : 0.0,
+        (unsigned long long)t.keyframes, t.keyframes ? (double)t.keyframeBytes / t.keyframes : 0.0,
+        (unsigned long long)t.games, t.maxLength);
+    printf("in %.1f KB/s total, %.1f B/s per session\n", bytes / elapsed / 1024,
+        clients.empty() ? 0.0 : bytes / elapsed / clients.size());
+    printf("keyframe checks %llu, mismatches %llu: %s\n", (unsigned long long)t.checked,
+        (unsigned long long)t.mismatches, t.mismatches == 0 && closed == 0 ? "MATCH" : "MISMATCH");
+    return t.mismatches == 0 && closed == 0 && probeOk ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+// SnakeServer.cpp — Máy chủ ván chơi: mỗi kết nối TCP là một ván SnakeSim do máy chủ giữ (NetProtocol.h)
+//
+// Một luồng, epoll, socket không chặn. Mỗi phiên chạy tick theo đúng nhịp GameLoop (MoveIntervalMs theo
+// level), lịch tick của mọi phiên nằm trong một heap nên chi phí mỗi tick là O(log số phiên). Mỗi tick
+// gửi một delta kích thước cố định; keyframe khi vào ván, qua màn, ván mới, định kỳ (sau delta cùng tick
+// để máy khách đối chiếu được) và khi máy khách xin. Khách đọc chậm: ngừng gửi delta khi hàng đợi gửi
+// vượt MAX_BACKLOG, gửi keyframe khi đã xả xong, nên bộ nhớ mỗi phiên có giới hạn.
+//
+// Build: g++ -O2 -std=c++17 -I.. SnakeServer.cpp ../NetProtocol.cpp ../NetSocket.cpp ../SnakeSim.cpp ../SnakeSave.cpp ../MapPack.cpp ../MappedFile.cpp ../SnakePolicy.cpp ../Autopilot.cpp ../CyclePilot.cpp -o SnakeServer
+// Dùng:  SnakeServer [--port N] [--speed hệ số] [--keyframe số tick] [--seconds N] [--seed N] [--pack levels.pack]
+//        --speed 10: nhịp nhanh gấp 10 lần để thử tải
+//        --pack: chơi trên gói màn chơi thay vì bộ map dựng sẵn; máy khách có bộ map khác bị ngắt khi HELLO
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include "ByteIO.h"
+#include "NetProtocol.h"
+#include "NetSocket.h"
+#include "MapPack.h"
+#include "SnakePolicy.h"
+#include "TurnBuffer.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+const size_t MAX_BACKLOG = 16 * 1024;   // Byte chờ gửi tối đa trước khi bỏ delta và chờ keyframe
+const size_t MAX_INPUT = 4096;          // Byte nhận chưa thành khung tối đa (khách gửi rác thì ngắt)
+const uint64_t LISTEN_TAG = ~0ull;
+
+struct Session {
+    int fd = -1;
+    uint32_t generation = 0;   // Tăng khi ô được dùng lại, để bỏ lịch tick của phiên cũ
+    bool started = false;      // Đã nhận NET_HELLO
+    SnakeSim sim;
+    TurnBuffer turns;
+    SnakePolicy bot;           // Có nếu khách xin NET_HELLO_AUTOPILOT
+    DeltaBase base;
+    vector<uint8_t> in;
+    vector<uint8_t> out;
+    size_t outPos = 0;
+    bool writeWatch = false;   // Đang đăng ký EPOLLOUT
+    bool stale = false;        // Đã bỏ delta vì khách đọc chậm
+    bool resync = false;
+    uint64_t sinceKeyframe = 0;
+};
+
+struct Due {
+    int64_t us;
+    int slot;
+    uint32_t generation;
+    bool operator>(const Due& o) const { return us > o.us; }
+};
+
+struct Stats {
+    uint64_t ticks = 0, deltas = 0, keyframes = 0, deltaBytes = 0, keyframeBytes = 0, games = 0, dropped = 0;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+class Server {
+public:
+    double speed = 1.0;
+    uint64_t keyframeInterval = 256;
+    uint64_t seed = 1;
+    const vector<MapData>* levels = nullptr;  // nullptr = bộ map dựng sẵn
+    uint32_t levelHash = 0;                   // LevelSetHash(levels), máy khách phải gửi đúng mã này
+    Stats stats;
+
+    bool Start(int port) {
+        listenFd = NetListen(port, 1024);
+        epollFd = epoll_create1(0);
+        if (listenFd < 0 || epollFd < 0) return false;
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = LISTEN_TAG;
+        return epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev) == 0;
+    }
+
+    void Run(double seconds) {
+        auto start = Clock::now();
+        auto lastReport = start;
+        Stats lastStats;
+        epoll_event events[256];
+        while (!stopRequested) {
+            int64_t now = NowUs();
+            int timeout = 1000;
+            if (!due.empty()) timeout = (int)max<int64_t>(0, (due.top().us - now + 999) / 1000);
+            int n = epoll_wait(epollFd, events, 256, timeout);
+            for (int i = 0; i < n; i++) {
+                if (events[i].data.u64 == LISTEN_TAG) Accept();
+                else HandleEvent((int)events[i].data.u64, events[i].events);
+            }
+
+            now = NowUs();
+            while (!due.empty() && due.top().us <= now) {
+                Due d = due.top();
+                due.pop();
+                Session* s = sessions[d.slot].get();
+                if (s->fd < 0 || s->generation != d.generation) continue;
+                Tick(d.slot);
+                if (s->fd < 0) continue;
+                // Giữ nhịp theo lịch, không trôi; tụt quá một nhịp thì bỏ phần tồn đọng như GameLoop
+                int64_t interval = IntervalUs(s->sim);
+                int64_t next = d.us + interval;
+                if (next < now) next = now + interval;
+                due.push({ next, d.slot, d.generation });
+            }
+
+            auto wall = Clock::now();
+            if (wall - lastReport >= chrono::seconds(5)) {
+                Report(chrono::duration<double>(wall - lastReport).count(), lastStats);
+                lastStats = stats;
+                lastReport = wall;
+            }
+            if (seconds > 0 && wall - start >= chrono::duration<double>(seconds)) break;
+        }
+    }
+
+    size_t ActiveSessions() const { return active; }
+
+private:
+    int listenFd = -1, epollFd = -1;
+    vector<unique_ptr<Session>> sessions;
+    vector<int> freeSlots;
+    priority_queue<Due, vector<Due>, greater<Due>> due;
+    size_t active = 0;
+    uint64_t gamesStarted = 0;
+    Clock::time_point epoch = Clock::now();
+
+    int64_t NowUs() const {
+        return chrono::duration_cast<chrono::microseconds>(Clock::now() - epoch).count();
+    }
+
+    int64_t IntervalUs(const SnakeSim& sim) const {
+        return (int64_t)(MoveIntervalMs(sim.speedLevel) * 1000.0 / speed);
+    }
+
+    void Accept() {
+        while (true) {
+            int fd = NetAccept(listenFd);
+            if (fd < 0) return;
+            int slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            else {
+                slot = (int)sessions.size();
+                sessions.push_back(make_unique<Session>());
+            }
+            Session& s = *sessions[slot];
+            uint32_t generation = s.generation + 1;
+            s = Session();
+            s.fd = fd;
+            s.generation = generation;
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = (uint64_t)slot;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                Close(slot);
+                continue;
+            }
+            active++;
+        }
+    }
+
+    void Close(int slot) {
+        Session& s = *sessions[slot];
+        if (s.fd < 0) return;
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, s.fd, nullptr);
+        NetClose(s.fd);
+        s.fd = -1;
+        s.generation++;
+        // Trả bộ nhớ của phiên về ngay, ô được dùng lại cho kết nối sau
+        vector<uint8_t>().swap(s.in);
+        vector<uint8_t>().swap(s.out);
+        s.bot = nullptr;
+        freeSlots.push_back(slot);
+        active--;
+    }
+
+    void HandleEvent(int slot, uint32_t events) {
+        Session& s = *sessions[slot];
+        if (s.fd < 0) return;
+        if (events & (EPOLLERR | EPOLLHUP)) {
+            Close(slot);
+            return;
+        }
+        if (events & EPOLLIN) {
+            uint8_t buf[4096];
+            while (true) {
+                long n = NetRecv(s.fd, buf, sizeof(buf));
+                if (n < 0) {
+                    Close(slot);
+                    return;
+                }
+                if (n == 0) break;
+                s.in.insert(s.in.end(), buf, buf + n);
+            }
+            size_t pos = 0;
+            int type;
+            const uint8_t* payload;
+            size_t size;
+            // HandleMessage có thể đóng phiên (Close đổi s.in thành rỗng): dừng ngay, không đọc tiếp bộ đệm cũ
+            while (s.fd >= 0 && NextFrame(s.in.data(), s.in.size(), pos, type, payload, size))
+                HandleMessage(slot, type, payload, size);
+            if (s.fd < 0) return;
+            s.in.erase(s.in.begin(), s.in.begin() + pos);
+            if (s.in.size() > MAX_INPUT) {
+                Close(slot);
+                return;
+            }
+        }
+        if (events & EPOLLOUT) Flush(slot);
+    }
+
+    void HandleMessage(int slot, int type, const uint8_t* payload, size_t size) {
+        Session& s = *sessions[slot];
+        if (type == NET_HELLO && !s.started) {
+            ByteReader r{ payload, payload + size };
+            uint32_t version = r.U8();
+            int flags = (int)r.U8();
+            uint32_t hash = r.U32();
+            if (!r.ok || version != NET_VERSION || hash != levelHash) {
+                Close(slot);
+                return;
+            }
+            s.started = true;
+            if (flags & NET_HELLO_AUTOPILOT) s.bot = MakePolicy("cycle", seed + gamesStarted);
+            NewGame(slot);
+            due.push({ NowUs() + IntervalUs(s.sim), slot, s.generation });
+        }
+        else if (type == NET_INPUT && s.started && size >= 1 && payload[0] < 4) {
+            s.turns.Push(payload[0], s.sim.moving);
+        }
+        else if (type == NET_RESYNC && s.started) {
+            s.resync = true;
+        }
+    }
+
+    void NewGame(int slot) {
+        Session& s = *sessions[slot];
+        // Seed riêng cho mỗi ván (splitmix64 của seed gốc + số thứ tự ván)
+        uint64_t z = seed + (++gamesStarted) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        s.sim.levels = levels;
+        s.sim.Reset(z ^ (z >> 31));
+        s.turns.Clear();
+        stats.games++;
+        SendKeyframe(slot);
+    }
+
+    void SendKeyframe(int slot) {
+        Session& s = *sessions[slot];
+        size_t before = s.out.size();
+        if (!EncodeKeyframe(s.sim, levelHash, s.out)) {
+            Close(slot);
+            return;
+        }
+        stats.keyframes++;
+        stats.keyframeBytes += s.out.size() - before;
+        s.sinceKeyframe = 0;
+        s.stale = s.resync = false;
+    }
+
+    void Tick(int slot) {
+        Session& s = *sessions[slot];
+        if (s.bot) s.sim.moving = NextDirection(s.sim, s.bot);
+        else {
+            int turn = s.turns.Pop(s.sim.moving, s.sim.snake.size());
+            if (turn >= 0) s.sim.moving = turn;
+        }
+        CaptureDeltaBase(s.sim, s.base);
+        int events = s.sim.Step(s.sim.moving);
+        stats.ticks++;
+        s.sinceKeyframe++;
+
+        if (s.out.size() - s.outPos > MAX_BACKLOG) {
+            s.stale = true;
+            stats.dropped++;
+        }
+        else if (s.stale || s.resync) SendKeyframe(slot);
+        else {
+            size_t before = s.out.size();
+            if (EncodeDelta(s.base, s.sim, events, s.out)) {
+                stats.deltas++;
+                stats.deltaBytes += s.out.size() - before;
+                if (s.sinceKeyframe >= keyframeInterval && s.sim.alive) SendKeyframe(slot);
+            }
+            else SendKeyframe(slot);
+        }
+        if (s.fd >= 0 && !s.sim.alive) NewGame(slot);
+        if (s.fd >= 0) Flush(slot);
+    }
+
+    void Flush(int slot) {
+        Session& s = *sessions[slot];
+        while (s.outPos < s.out.size()) {
+            long n = NetSend(s.fd, s.out.data() + s.outPos, s.out.size() - s.outPos);
+            if (n < 0) {
+                Close(slot);
+                return;
+            }
+            if (n == 0) break;
+            s.outPos += (size_t)n;
+        }
+        bool pending = s.outPos < s.out.size();
+        if (!pending) {
+            s.out.clear();
+            s.outPos = 0;
+        }
+        else if (s.outPos > s.out.size() / 2) {
+            s.out.erase(s.out.begin(), s.out.begin() + s.outPos);
+            s.outPos = 0;
+        }
+        if (pending != s.writeWatch) {
+            epoll_event ev{};
+            ev.events = pending ? EPOLLIN | EPOLLOUT : EPOLLIN;
+            ev.data.u64 = (uint64_t)slot;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, s.fd, &ev);
+            s.writeWatch = pending;
+        }
+    }
+
+    void Report(double seconds, const Stats& last) {
+        static rusage lastUsage{};
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        auto cpu = [](const rusage& u) {
+            return u.ru_utime.tv_sec + u.ru_stime.tv_sec + (u.ru_utime.tv_usec + u.ru_stime.tv_usec) / 1e6;
+        };
+        double cpuSeconds = cpu(usage) - cpu(lastUsage);
+        lastUsage = usage;
+
+        uint64_t deltas = stats.deltas - last.deltas;
+        uint64_t bytes = stats.deltaBytes - last.deltaBytes + stats.keyframeBytes - last.keyframeBytes;
+        printf("%zu sessions | %.0f ticks/s | out %.1f KB/s (%.1f B/delta, %llu keyframes, %llu dropped) | CPU %.1f%%\n",
+            active, (stats.ticks - last.ticks) / seconds, bytes / seconds / 1024,
+            deltas ? (double)(stats.deltaBytes - last.deltaBytes) / deltas : 0.0,
+            (unsigned long long)(stats.keyframes - last.keyframes), (unsigned long long)(stats.dropped - last.dropped),
+            100.0 * cpuSeconds / seconds);
+        fflush(stdout);
+    }
+};
+
+// Mỗi phiên một fd: nâng giới hạn số fd lên mức tối đa cho phép
+static void RaiseFileLimit() {
+    rlimit lim{};
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+int main(int argc, char** argv) {
+    int port = NET_DEFAULT_PORT;
+    double seconds = 0;
+    Server server;
+    const char* packPath = nullptr;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--port") == 0) port = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "--speed") == 0) server.speed = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--keyframe") == 0) server.keyframeInterval = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--seconds") == 0) seconds = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--seed") == 0) server.seed = strtoull(argv[i + 1], nullptr, 10);
+        else if (strcmp(argv[i], "--pack") == 0) packPath = argv[i + 1];
+        else break;
+    }
+    if (argc % 2 == 0 || server.speed <= 0 || server.keyframeInterval == 0) {
+        printf("Usage: %s [--port N] [--speed factor] [--keyframe ticks] [--seconds N] [--seed N] [--pack levels.pack]\n", argv[0]);
+        return 2;
+    }
+    vector<MapData> packMaps;
+    if (packPath) {
+        MapPack pack;
+        if (!pack.Open(packPath) || !pack.LoadAll(packMaps)) {
+            printf("Cannot read level pack %s\n", packPath);
+            return 2;
+        }
+        server.levels = &packMaps;
+    }
+    server.levelHash = LevelSetHash(packPath ? packMaps : DefaultLevelMaps());
+
+    RaiseFileLimit();
+    signal(SIGINT, [](int) { stopRequested = 1; });
+    signal(SIGTERM, [](int) { stopRequested = 1; });
+    if (!server.Start(port)) {
+        printf("Cannot listen on port %d\n", port);
+        return 1;
+    }
+    printf("Listening on port %d (speed x%g, keyframe every %llu ticks, level set %08x)\n", port, server.speed,
+        (unsigned long long)server.keyframeInterval, server.levelHash);
+    fflush(stdout);
+    server.Run(seconds);
+
+    const Stats& st = server.stats;
+    printf("Total: %llu games, %llu ticks, %llu deltas (%.1f B avg), %llu keyframes (%.1f B avg)\n",
+        (unsigned long long)st.games, (unsigned long long)st.ticks, (unsigned long long)st.deltas,
+        st.deltas ? (double)st.deltaBytes / st.deltas : 0.0, (unsigned long long)st.keyframes,
+        st.keyframes ? (double)st.keyframeBytes / st.keyframes : 0.0);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// SnapshotCheck.cpp — Kiểm tra snapshot (SnakeSave) và delta mạng (NetProtocol) giữ đúng tọa độ trên bàn lớn
+//
+// Bàn rộng hơn 32767 ô: cổng, mồi và thân rắn nằm ở x > 32767 phải giải mã ra đúng tọa độ (u16, không
+// qua số có dấu). Bàn 65535 x 65535: lưu rồi nạp lại không cấp phát theo diện tích bàn.
+// Snapshot có mồi hoặc thân rắn ngoài vùng chơi, hay mồi trên tường, phải bị từ chối.
+//
+// Build: g++ -O2 -std=c++17 -I.. SnapshotCheck.cpp ../SnakeSim.cpp ../SnakeSave.cpp ../NetProtocol.cpp ../MappedFile.cpp -o SnapshotCheck
+// Dùng:  SnapshotCheck
+//        Trả về 1 nếu có bước sai
+
+#include <cstdio>
+#include <vector>
+#include "SnakeSave.h"
+#include "NetProtocol.h"
+
+using namespace std;
+
+static vector<MapData> OpenBoard(int width, int height) {
+    vector<MapData> maps(1);
+    maps[0].width = width;
+    maps[0].height = height;
+    maps[0].startPos = { width / 2, height / 2 };
+    maps[0].themeName = "Open";
+    maps[0].backgroundColor = 7;
+    InitMapTiles(maps[0]);
+    return maps;
+}
+
+static bool SameState(const SnakeSim& a, const SnakeSim& b) {
+    if (a.alive != b.alive || a.ticks != b.ticks || a.score != b.score || a.speedLevel != b.speedLevel ||
+        a.moving != b.moving || a.rng.state != b.rng.state || a.foodIndex != b.foodIndex ||
+        a.foodVisible != b.foodVisible || a.gateActive != b.gateActive || a.gatePos != b.gatePos ||
+        a.foods != b.foods || a.snake.size() != b.snake.size())
+        return false;
+    for (size_t i = 0; i < a.snake.size(); i++)
+        if (a.snake[i] != b.snake[i]) return false;
+    return true;
+}
+
+static bool Report(const char* name, bool ok) {
+    printf("  %-40s %s\n", name, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Rắn nằm ngang ở hàng y, đuôi tại x
+static void PlaceSnake(SnakeSim& sim, int x, int y, int len) {
+    sim.snake.clear();
+    for (int i = 0; i < len; i++) sim.snake.push_back({ x + i, y });
+    sim.RebuildOccupancy();
+}
+
+int main() {
+    bool allOk = true;
+
+    // Bàn 40960 x 64: mọi tọa độ trạng thái đều vượt 32767
+    vector<MapData> wide = OpenBoard(40960, 64);
+    SnakeSim sim;
+    sim.levels = &wide;
+    sim.Reset(7);
+    PlaceSnake(sim, 39000, 20, 12);
+    for (size_t i = 0; i < sim.foods.size(); i++) sim.foods[i] = { 33000 + (int)i * 1000, 30 };
+    sim.foodIndex = 1;
+
+    vector<uint8_t> buf;
+    SnakeSim loaded;
+    loaded.levels = &wide;
+    bool ok = EncodeSnapshot(sim, buf) && DecodeSnapshot(loaded, buf.data(), buf.size()) && SameState(sim, loaded);
+    allOk &= Report("snapshot 40960x64, gate closed", ok);
+
+    sim.gateActive = true;
+    sim.gatePos = { 40000, 1 };
+    sim.foodVisible = false;
+    buf.clear();
+    ok = EncodeSnapshot(sim, buf) && DecodeSnapshot(loaded, buf.data(), buf.size()) && SameState(sim, loaded);
+    allOk &= Report("snapshot 40960x64, gate at x=40000", ok);
+
+    // Keyframe lúc cổng đóng, rồi delta mở cổng và delta đi một bước
+    SnakeSim mirror;
+    mirror.levels = &wide;
+    sim.gateActive = false;
+    sim.gatePos = { -1, -1 };
+    sim.foodVisible = true;
+    vector<uint8_t> frame;
+    uint32_t wideHash = LevelSetHash(wide);
+    ok = EncodeKeyframe(sim, wideHash, frame) &&
+        ApplyKeyframe(mirror, frame.data() + NET_FRAME_HEADER, frame.size() - NET_FRAME_HEADER, wideHash);
+    DeltaBase base;
+    CaptureDeltaBase(sim, base);
+
+    sim.ticks++;
+    sim.gateActive = true;
+    sim.gatePos = { wide[0].width - 1, 40 };
+    sim.foodVisible = false;
+    frame.clear();
+    bool dead = false;
+    ok = ok && EncodeDelta(base, sim, EVT_NONE, frame) &&
+        ApplyDelta(mirror, frame.data() + NET_FRAME_HEADER, frame.size() - NET_FRAME_HEADER, dead) &&
+        SameState(sim, mirror);
+    CaptureDeltaBase(sim, base);
+
+    sim.ticks++;
+    sim.snake.push_back({ sim.snake.back().x + 1, sim.snake.back().y });
+    sim.snake.pop_front();
+    frame.clear();
+    ok = ok && EncodeDelta(base, sim, EVT_MOVED, frame) &&
+        ApplyDelta(mirror, frame.data() + NET_FRAME_HEADER, frame.size() - NET_FRAME_HEADER, dead) &&
+        SameState(sim, mirror);
+    allOk &= Report("keyframe + deltas 40960x64", ok);
+
+    // Bàn lớn nhất: snapshot chỉ giữ trước thân rắn theo độ dài, không theo 65535 x 65535 ô
+    vector<MapData> huge = OpenBoard(MAX_BOARD_SIZE, MAX_BOARD_SIZE);
+    SnakeSim big;
+    big.levels = &huge;
+    big.Reset(11);
+    PlaceSnake(big, 60000, 60000, 20);
+    big.gateActive = true;
+    big.gatePos = { 1, 65000 };
+    SnakeSim bigLoaded;
+    bigLoaded.levels = &huge;
+    buf.clear();
+    ok = EncodeSnapshot(big, buf) && DecodeSnapshot(bigLoaded, buf.data(), buf.size()) && SameState(big, bigLoaded);
+    allOk &= Report("snapshot 65535x65535", ok);
+
+    // Tọa độ hỏng: bàn 41 x 21 có chu trình Hamilton (CyclePilot đánh chỉ số cycleOrder theo mồi)
+    vector<MapData> small = OpenBoard(41, 21);
+    BuildHamiltonCycle(small[0]);
+    SetTile(small[0], 5, 5, TILE_WALL);
+    SnakeSim bad;
+    bad.levels = &small;
+    bad.Reset(3);
+    SnakeSim badLoaded;
+    badLoaded.levels = &small;
+    auto rejected = [&](const SnakeSim& s) {
+        buf.clear();
+        return EncodeSnapshot(s, buf) && !DecodeSnapshot(badLoaded, buf.data(), buf.size());
+    };
+    SnakeSim edited = bad;
+    edited.foods[0] = { 60000, 60000 };
+    allOk &= Report("reject food outside the board", rejected(edited));
+    edited = bad;
+    edited.foods[0] = { 5, 5 };
+    allOk &= Report("reject food on a wall", rejected(edited));
+    edited = bad;
+    edited.snake.push_back({ 60000, 3 });  // Không kề đoạn trước: mã hóa RAW
+    allOk &= Report("reject raw body cell outside the board", rejected(edited));
+    edited = bad;
+    edited.snake.push_back({ edited.snake.back().x, 0 });
+    allOk &= Report("reject body cell on the border", rejected(edited));
+    buf.clear();
+    allOk &= Report("accept the unedited game", EncodeSnapshot(bad, buf) && DecodeSnapshot(badLoaded, buf.data(), buf.size()));
+
+    printf("%s\n", allOk ? "ALL OK" : "FAILED");
+    return allOk ? 0 : 1;
+}